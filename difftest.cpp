@@ -0,0 +1,743 @@
+// difftest.cpp
+// Differential harness for sched_core.h. Every engine runs against a deliberately naive
+// reference of the same policy (one quantum or one tick per step, linear scans of the
+// ready list, no solo-run shortcuts, no heaps or trees, and none of the engine's I/O,
+// switch-cost or DVFS helpers) on randomized workloads. The merged Gantt chart, the
+// finishing time, the energy and every job's turnaround, waiting and I/O time must
+// match exactly. Cases cover switch, cache and migration costs, and the two governors
+// that run below full speed (CFS steady, EDF deadline). A second pass times both (best
+// of three) on a large saturated workload and fails if an engine is clearly slower
+// than its reference.
+// Usage: difftest [ROUNDS] [SEED]
+#include "sched_core.h"
+
+// -------------- Reference plumbing --------------
+// Written apart from the engine's helpers, so a slip in those shows up as a disagreement
+// rather than on both sides: arrivals and I/O completions found by scanning, bursts and
+// switches accounted by hand, and DVFS work counted in whole millionths of a unit
+// instead of the engine's floating carry. A job's waiting time is what is left of its
+// turnaround after its time on the CPU and blocked on I/O.
+class RefBase: public Scheduler{
+protected:
+    static constexpr Time MICRO=1000000;           // work units per unit of work done
+    int nextIdx=0, holder=-1, pstate=0;            // next arrival; job whose slice is last in the chart (-1: idle or a switch)
+    vector<pair<Time,int>> waking;                 // (I/O done, job), unordered
+    vector<Time> devFree, lastEnd, part, onCpu;    // part: millionths done towards the job's next whole unit
+
+    void start(vector<Process>& ps){
+        sortByArrival(ps);
+        int n=ps.size(), nd=0;
+        for(auto& p: ps){
+            if(p.bursts.empty()) p.bursts={p.burst_time};
+            p.bidx=0; p.remaining_time=p.bursts[0]; p.io_time=0;
+            for(int d: p.devs) nd=max(nd, d+1);
+        }
+        nextIdx=0; holder=-1; pstate=power.top(); waking.clear();
+        devFree.assign(nd, 0); lastEnd.assign(n, -1); part.assign(n, 0); onCpu.assign(n, 0);
+        busyAt.assign(power.freq.size(), 0); idleTime=0;
+    }
+    // Everything ready by t, oldest first; at equal times arrivals go before wakeups,
+    // and wakeups by job index.
+    template<class F>
+    void arrivals(vector<Process>& ps, Time t, F push){
+        vector<tuple<Time,int,int>> ev;
+        for(; nextIdx<(int)ps.size() && ps[nextIdx].arrival_time<=t; nextIdx++) ev.emplace_back(ps[nextIdx].arrival_time, 0, nextIdx);
+        for(size_t k=0;k<waking.size();){
+            if(waking[k].first<=t){ ev.emplace_back(waking[k].first, 1, waking[k].second); waking.erase(waking.begin()+k); }
+            else k++;
+        }
+        sort(ev.begin(), ev.end());
+        for(auto& [at,wake,i]: ev){
+            if(wake){ ps[i].bidx++; ps[i].remaining_time=ps[i].bursts[ps[i].bidx]; }
+            push(i);
+        }
+    }
+    Time nextAt(const vector<Process>& ps) const {
+        Time nx= nextIdx<(int)ps.size()? ps[nextIdx].arrival_time : TIME_MAX;
+        for(auto& w: waking) nx=min(nx, w.first);
+        return nx;
+    }
+    void slice(Gantt& g, const string& id, Time len){
+        g.push_back({id, len});
+        if(id=="IDLE") idleTime+=len; else busyAt[pstate]+=len;
+    }
+    void idle(Time& t, Time to, Gantt& g){ if(to>t){ slice(g, "IDLE", to-t); t=to; holder=-1; } }
+    // Hands the CPU to job i at t; true if that took time.
+    bool pay(const vector<Process>& ps, int i, Time& t, Gantt& g){
+        if(!cost.on() || holder==i) return false;
+        Time c=cost.cswitch;
+        if(lastEnd[i]>=0) c += cost.decay>0? cost.warm*min(t-lastEnd[i], cost.decay)/cost.decay : cost.warm;
+        else if(ps[i].migrated) c += cost.migrate;
+        if(c==0) return false;
+        slice(g, "CS", c); t+=c; holder=-1;
+        return true;
+    }
+    Time speed(int l) const { return min(MICRO, (Time)llround(power.freq[l]*MICRO)); }
+    // Time job i needs to finish its burst at P-state l; full speed rounds it to whole
+    // units, dropping any part of a unit done slower.
+    Time wallAt(const vector<Process>& ps, int i, int l) const {
+        Time f=speed(l), rest=ps[i].remaining_time*MICRO-(f==MICRO? 0 : part[i]);
+        return max<Time>(1, (rest+f-1)/f);
+    }
+    // Job i holds the CPU for len from t, already paid for.
+    void exec(vector<Process>& ps, int i, Time len, Time& t, Gantt& g){
+        Process& p=ps[i]; Time f=speed(pstate);
+        if(f==MICRO) part[i]=0;
+        Time w=len*f+part[i], done=min(p.remaining_time, w/MICRO);
+        part[i]= done==p.remaining_time? 0 : w-done*MICRO;
+        p.remaining_time-=done;
+        slice(g, p.id, len); t+=len; onCpu[i]+=len; lastEnd[i]=t; holder=i;
+    }
+    void run(vector<Process>& ps, int i, Time len, Time& t, Gantt& g){ pay(ps, i, t, g); exec(ps, i, len, t, g); }
+    // Job i drained its burst at t: true when it is done, else it joins its device's queue.
+    bool finish(vector<Process>& ps, int i, Time t){
+        Process& p=ps[i]; part[i]=0;
+        if(p.bidx+1==(int)p.bursts.size()){
+            p.turnaround_time=t-p.arrival_time;
+            p.waiting_time=p.turnaround_time-onCpu[i]-p.io_time;
+            return true;
+        }
+        p.bidx++; p.remaining_time=0;
+        int d=p.devs[p.bidx/2]; devFree[d]=max(t, devFree[d])+p.bursts[p.bidx];
+        p.io_time+=devFree[d]-t; waking.push_back({devFree[d], i});
+        return false;
+    }
+};
+
+// -------------- Reference engines --------------
+// Position in rq of the job with the smallest key(i); ties go to the lowest index,
+// i.e. the earliest arrival, as in ReadySet.
+template<class F>
+static size_t argminBy(const vector<int>& rq, F key){
+    size_t b=0;
+    for(size_t k=1;k<rq.size();k++){
+        auto a=key(rq[k]), c=key(rq[b]);
+        if(a<c || (a==c && rq[k]<rq[b])) b=k;
+    }
+    return b;
+}
+static int take(vector<int>& rq, size_t k){ int i=rq[k]; rq.erase(rq.begin()+k); return i; }
+
+// Run-to-completion policies: pick by key (FCFS: in ready order), run the whole burst.
+template<class Key>
+class RefNonPreemptive: public RefBase{
+    string nm; Key key;
+public:
+    RefNonPreemptive(string n, Key k): nm(move(n)), key(k) {}
+    string name() const override { return nm; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        int n=ps.size(), fin=0; Time t=0, last_age=0; vector<int> rq;
+        while(fin<n){
+            arrivals(ps, t, [&](int i){ rq.push_back(i); });
+            if(nm=="priority" && t-last_age>=5){
+                for(int i: rq) ps[i].priority=max(0, ps[i].priority-1);
+                last_age=t;
+            }
+            if(rq.empty()){ idle(t, nextAt(ps), g); continue; }
+            int i=take(rq, nm=="fcfs"? 0 : argminBy(rq, [&](int j){ return key(ps[j]); }));
+            run(ps, i, ps[i].remaining_time, t, g);
+            if(finish(ps,i,t)) fin++;
+        }
+        total=t;
+    }
+};
+template<class Key> static unique_ptr<Scheduler> nonPreemptive(string n, Key k){ return make_unique<RefNonPreemptive<Key>>(n, k); }
+
+// SRTF, one tick at a time. A job arriving during a switch is admitted before the
+// switched-to job runs, and may take the CPU from it.
+class RefSRTF: public RefBase{
+public: string name() const override { return "srtf"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        int n=ps.size(), fin=0, last=-1; Time t=0; vector<int> rq;
+        while(fin<n){
+            arrivals(ps, t, [&](int i){ rq.push_back(i); });
+            if(rq.empty()){ idle(t, nextAt(ps), g); last=-1; continue; }
+            size_t k=argminBy(rq, [&](int j){ return ps[j].remaining_time; });
+            int i=rq[k];
+            if(i!=last){ last=i; if(pay(ps, i, t, g)) continue; }
+            exec(ps, i, 1, t, g);
+            if(ps[i].remaining_time==0){ rq.erase(rq.begin()+k); last=-1; if(finish(ps,i,t)) fin++; }
+        }
+        total=t;
+    }
+};
+
+// Round robin, one quantum per step.
+class RefRR: public RefBase{
+    Time q;
+public:
+    explicit RefRR(Time quantum): q(quantum) {}
+    string name() const override { return "rr"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        int n=ps.size(), fin=0; Time t=0; vector<int> rq;
+        auto arrive=[&](){ arrivals(ps, t, [&](int i){ rq.push_back(i); }); };
+        arrive();
+        while(fin<n){
+            if(rq.empty()){ idle(t, nextAt(ps), g); arrive(); continue; }
+            int i=take(rq, 0);
+            run(ps, i, min(q, ps[i].remaining_time), t, g);
+            if(ps[i].remaining_time==0 && finish(ps,i,t)) fin++;
+            arrive();
+            if(ps[i].remaining_time>0) rq.push_back(i);
+        }
+        total=t;
+    }
+};
+
+// MLQ: classes rescanned per step; wrr/drr credit handed out one turn at a time.
+class RefMLQ: public RefBase{
+    vector<MLQClass> cls; string share; Time slot;
+public:
+    RefMLQ(vector<MLQClass> c, string sh, Time s): cls(move(c)), share(move(sh)), slot(s) {
+        if(cls.empty()) cls={ {INT_MIN,2,'r',4,1}, {3,INT_MAX,'f',0,1} };
+    }
+    string name() const override { return "mlq"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        int n=ps.size(), nc=cls.size(), fin=0, turn=0; Time t=0;
+        vector<int> of(n, nc-1);
+        for(int i=0;i<n;i++) for(int c=0;c<nc;c++) if(ps[i].priority>=cls[c].lo && ps[i].priority<=cls[c].hi){ of[i]=c; break; }
+        vector<vector<int>> q(nc); vector<int> cur(nc,-1); vector<Time> credit(nc,0);
+        credit[0]=(Time)cls[0].weight*slot;
+        auto arrive=[&](){ arrivals(ps, t, [&](int i){ q[of[i]].push_back(i); }); };
+        auto empty=[&](int c){ return cur[c]<0 && q[c].empty(); };
+        auto headPos=[&](int c)->size_t{ return cls[c].disc=='s'? argminBy(q[c], [&](int j){ return ps[j].remaining_time; }) : 0; };
+        auto head=[&](int c){ return cur[c]>=0? cur[c] : q[c][headPos(c)]; };
+        auto want=[&](int c){ int i=head(c); return cls[c].disc=='r'? min(cls[c].quantum, ps[i].remaining_time) : ps[i].remaining_time; };
+        auto pickClass=[&]()->int{
+            int c=0; while(c<nc && empty(c)) c++;
+            if(c==nc || share=="strict") return c==nc? -1 : c;
+            for(;;){
+                if(empty(turn)) credit[turn]=0;
+                else if(share=="wrr"? credit[turn]>0 : want(turn)<=credit[turn]) return turn;
+                turn=(turn+1)%nc;
+                credit[turn] = (share=="wrr"? 0 : credit[turn]) + (Time)cls[turn].weight*slot;
+            }
+        };
+        arrive();
+        while(fin<n){
+            int c=pickClass();
+            if(c==-1){ idle(t, nextAt(ps), g); arrive(); continue; }
+            int ready=0; for(int k=0;k<nc;k++) ready+=q[k].size()+(cur[k]>=0);
+            Time slice=want(c); int i;
+            if(cur[c]>=0) i=cur[c];
+            else { i=take(q[c], headPos(c)); if(cls[c].disc!='r') cur[c]=i; }
+            if(ready>1 && share!="strict"){
+                if(share=="wrr") slice=min(slice, credit[c]);
+                credit[c]-=slice;
+            }
+            run(ps, i, slice, t, g);
+            bool done=ps[i].remaining_time==0;
+            if(done){ cur[c]=-1; if(finish(ps,i,t)) fin++; }
+            arrive();
+            if(!done && cls[c].disc=='r') q[c].push_back(i);
+        }
+        total=t;
+    }
+};
+
+// MLFQ, one quantum per step.
+class RefMLFQ: public RefBase{
+public: string name() const override { return "mlfq"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        const Time Q[3]={2,4,8};
+        vector<int> q[3]; int n=ps.size(), fin=0; Time t=0;
+        for(auto& p: ps) p.qlevel=0;
+        auto arrive=[&](){ arrivals(ps, t, [&](int i){ q[ps[i].qlevel].push_back(i); }); };
+        arrive();
+        while(fin<n){
+            if(t>0 && t%12==0) for(int L=2; L>=1; L--){
+                for(int i: q[L]){ ps[i].qlevel=L-1; q[L-1].push_back(i); }
+                q[L].clear();
+            }
+            int L=0; while(L<3 && q[L].empty()) L++;
+            if(L==3){ idle(t, nextAt(ps), g); arrive(); continue; }
+            int i=take(q[L], 0);
+            Time slice=min(Q[L], ps[i].remaining_time);
+            run(ps, i, slice, t, g);
+            if(ps[i].remaining_time==0 && finish(ps,i,t)) fin++;
+            arrive();
+            if(ps[i].remaining_time>0){ ps[i].qlevel=(slice==Q[L] && L<2)? L+1 : L; q[ps[i].qlevel].push_back(i); }
+        }
+        total=t;
+    }
+};
+
+// Lottery, one quantum and (with competition) one draw per step.
+class RefLottery: public RefBase{
+    uint32_t seed;
+public:
+    explicit RefLottery(uint32_t s): seed(s) {}
+    string name() const override { return "lottery"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        int n=ps.size(), fin=0; Time t=0; vector<int> rq; mt19937 gen(seed);
+        while(fin<n){
+            rq.erase(remove_if(rq.begin(), rq.end(), [&](int i){ return ps[i].remaining_time==0; }), rq.end());
+            arrivals(ps, t, [&](int i){ rq.push_back(i); });
+            if(rq.empty()){ idle(t, nextAt(ps), g); continue; }
+            int i=rq[0];
+            if(rq.size()>1){
+                int tot=0; for(int j: rq) tot+=tickets(ps[j]);
+                int pick=uniform_int_distribution<int>(1,tot)(gen), acc=0;
+                for(int j: rq){ acc+=tickets(ps[j]); if(pick<=acc){ i=j; break; } }
+            }
+            run(ps, i, min<Time>(4, ps[i].remaining_time), t, g);
+            if(ps[i].remaining_time==0 && finish(ps,i,t)) fin++;
+        }
+        total=t;
+    }
+};
+
+// Stride, one quantum per step, lowest (pass, index) found by scan.
+class RefStride: public RefBase{
+public: string name() const override { return "stride"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps); const Time STRIDE1=1<<20;
+        int n=ps.size(), fin=0; Time t=0; vector<int> rq;
+        vector<Time> pass(n,0), left(n,0); long long readyTickets=0;
+        double gbase=0; Time gran=0;                  // global pass: gbase + gran*STRIDE1/readyTickets
+        auto global=[&](){ if(gran) gbase+=gran/((double)readyTickets/STRIDE1); gran=0; return (Time)gbase; };
+        auto arrive=[&](){ arrivals(ps, t, [&](int i){
+            pass[i]=global()+left[i]; readyTickets+=tickets(ps[i]); rq.push_back(i);
+        }); };
+        arrive();
+        while(fin<n){
+            if(rq.empty()){ idle(t, nextAt(ps), g); arrive(); continue; }
+            size_t k=argminBy(rq, [&](int j){ return pass[j]; }); int i=rq[k];
+            Time slice=min<Time>(4, ps[i].remaining_time);
+            run(ps, i, slice, t, g);
+            pass[i]+=STRIDE1/tickets(ps[i])*slice; gran+=slice;
+            if(ps[i].remaining_time==0){
+                rq.erase(rq.begin()+k); left[i]=pass[i]-global(); readyTickets-=tickets(ps[i]);
+                if(finish(ps,i,t)) fin++;
+            }
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// CFS-lite, one slice per step, smallest vruntime found by scan. With weights 1/p a
+// slice of d adds exactly d*p, so vruntime is kept as an integer. Governor steady: the
+// decaying util estimate after every step, as in the engine.
+class RefCFS: public RefBase{
+    string governor;
+public:
+    explicit RefCFS(string gov): governor(move(gov)) {}
+    string name() const override { return "cfs"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        int n=ps.size(), fin=0; Time t=0; vector<int> rq; vector<Time> vr(n,0);
+        bool steady= governor=="steady"; double util=0;
+        auto demand=[&](Time from, Time work){
+            if(!steady || t<=from) return;
+            double a=pow(0.5, (t-from)/8.0);
+            util=util*a + (double)work/(t-from)*(1-a);
+            pstate=power.atLeast(min(1.0, 1.25*util));
+        };
+        if(steady) pstate=0;
+        auto key=[&](int j){ return vr[j]; };
+        auto arrive=[&](){ arrivals(ps, t, [&](int i){
+            if(ps[i].bidx>0 && !rq.empty()) vr[i]=max(vr[i], vr[rq[argminBy(rq,key)]]);
+            rq.push_back(i);
+        }); };
+        arrive();
+        while(fin<n){
+            Time from=t;
+            if(rq.empty()){ idle(t, nextAt(ps), g); demand(from, 0); arrive(); continue; }
+            size_t k=argminBy(rq, key); int i=rq[k];
+            Time p=max(1, ps[i].priority);
+            Time slice=max<Time>(1, min((4+p-1)/p, wallAt(ps, i, pstate))), left=ps[i].remaining_time;
+            run(ps, i, slice, t, g); vr[i]+=slice*p;
+            demand(from, left-ps[i].remaining_time);
+            if(ps[i].remaining_time==0){ rq.erase(rq.begin()+k); if(finish(ps,i,t)) fin++; }
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// EEVDF, one request per step: earliest virtual deadline among the eligible by scan.
+// A job's virtual time is base + ran/w, ran being its CPU since it joined, so V, the
+// weighted mean over the ready jobs, is (A+E)/W with A the sum of w*base and E of ran.
+// Summing the slices one by one instead rounds differently and breaks exact ties.
+class RefEEVDF: public RefBase{
+public: string name() const override { return "eevdf"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps); const int REQUEST=4;
+        int n=ps.size(), fin=0; Time t=0; vector<int> rq;
+        vector<double> base(n,0), lag(n,0); vector<Time> ran(n,0); double A=0, W=0, V=0; Time E=0;
+        auto wt=[&](int i){ return 1.0/max(1, ps[i].priority); };
+        auto ve=[&](int i){ return ran[i]? base[i]+ran[i]/wt(i) : base[i]; };
+        auto vd=[&](int i){ return ve(i)+REQUEST/wt(i); };
+        auto arrive=[&](){ arrivals(ps, t, [&](int i){
+            double w=wt(i);
+            base[i]= W>0? V - lag[i]*(W+w)/(W*w) : V; ran[i]=0;
+            A+=w*base[i]; W+=w; V=(A+E)/W; rq.push_back(i);
+        }); };
+        arrive();
+        while(fin<n){
+            if(rq.empty()){ idle(t, nextAt(ps), g); arrive(); continue; }
+            size_t k=rq.size();
+            for(size_t j=0;j<rq.size();j++) if(ve(rq[j])<=V)
+                if(k==rq.size() || make_pair(vd(rq[j]),rq[j])<make_pair(vd(rq[k]),rq[k])) k=j;
+            if(k==rq.size()) k=argminBy(rq, ve);
+            int i=rq[k];
+            Time slice=min<Time>(REQUEST, ps[i].remaining_time);
+            run(ps, i, slice, t, g);
+            ran[i]+=slice; E+=slice; V=(A+E)/W;
+            if(ps[i].remaining_time==0){
+                double w=wt(i);
+                lag[i]=clamp(w*(V-ve(i)), -(double)REQUEST, (double)REQUEST);
+                A-=w*base[i]; E-=ran[i]; W-=w;
+                if(W>1e-9) V=(A+E)/W; else A=W=0;
+                rq.erase(rq.begin()+k);
+                if(finish(ps,i,t)) fin++;
+            }
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// Hierarchical fair share, one slice per step; each level's runnable children scanned.
+// An entity's vruntime is base + ran/w, as in EEVDF.
+class RefGroup: public RefBase{
+    map<string,double> weights;
+public:
+    explicit RefGroup(map<string,double> w): weights(move(w)) {}
+    string name() const override { return "group"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        int n=ps.size(), fin=0; Time t=0;
+        vector<int> parent(n+1,-1); vector<double> base(n+1,0), w(n+1,1.0); map<string,int> gid{{"",n}};
+        for(int i=0;i<n;i++){
+            int at=n; string path;
+            istringstream ss(ps[i].group);
+            for(string part; getline(ss,part,'/'); ){
+                if(part.empty()) continue;
+                path += (path.empty()? "" : "/") + part;
+                if(!gid.count(path)){
+                    gid[path]=parent.size(); parent.push_back(at); base.push_back(0);
+                    w.push_back(weights.count(path)? weights[path] : 1.0);
+                }
+                at=gid[path];
+            }
+            parent[i]=at; w[i]=1.0/max(1,ps[i].priority);
+        }
+        vector<vector<int>> kids(parent.size()); vector<Time> ran(parent.size(), 0);
+        auto vr=[&](int e){ return ran[e]? base[e]+ran[e]/w[e] : base[e]; };
+        function<void(int)> enqueue=[&](int e){
+            int p=parent[e]; bool wasIdle=kids[p].empty();
+            if(!wasIdle){ base[e]=max(vr(e), vr(kids[p][argminBy(kids[p],vr)])); ran[e]=0; }
+            kids[p].push_back(e);
+            if(wasIdle && parent[p]>=0) enqueue(p);
+        };
+        function<void(int)> dequeue=[&](int e){
+            int p=parent[e]; kids[p].erase(find(kids[p].begin(), kids[p].end(), e));
+            if(kids[p].empty() && parent[p]>=0) dequeue(p);
+        };
+        auto arrive=[&](){ arrivals(ps, t, enqueue); };
+        arrive();
+        while(fin<n){
+            if(kids[n].empty()){ idle(t, nextAt(ps), g); arrive(); continue; }
+            int i=n; while(i>=n) i=kids[i][argminBy(kids[i],vr)];
+            Time slice=max<Time>(1, min((Time)ceil(4*w[i]), ps[i].remaining_time));
+            run(ps, i, slice, t, g);
+            for(int e=i; parent[e]>=0; e=parent[e]) ran[e]+=slice;
+            if(ps[i].remaining_time==0){ dequeue(i); if(finish(ps,i,t)) fin++; }
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// EDF, one tick at a time. Admission re-adds every admitted job's outstanding CPU in
+// deadline order and checks each prefix against its deadline. Governor deadline: the
+// same prefix check per P-state, with one unit of slack per job, redone whenever the
+// engine would end a step (a switch, a completion, the next arrival or wakeup).
+class RefEDF: public RefBase{
+    string admission, governor;
+public:
+    RefEDF(string adm, string gov): admission(move(adm)), governor(move(gov)) {}
+    string name() const override { return "edf"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        start(ps);
+        for(auto& p: ps) if(p.deadline==0) p.deadline = p.arrival_time + 2*p.burst_time;
+        int n=ps.size(), fin=0, last=-1; Time t=0, until=0; vector<int> rq, bg;
+        bool dvfs= governor=="deadline";
+        vector<char> ok(n,1), in(n,0), placed(n,0); vector<Time> owe(n,0), left(n,0);
+        auto order=[&](int a){ return make_pair(ps[a].deadline, a); };
+        auto fits=[&](int i){
+            vector<int> set{i}; for(int j=0;j<n;j++) if(in[j]) set.push_back(j);
+            sort(set.begin(), set.end(), [&](int a, int b){ return order(a)<order(b); });
+            Time demand=0;
+            for(int j: set){
+                demand+=owe[j];
+                if(order(j)>=order(i) && demand>ps[j].deadline-t) return false;
+            }
+            return true;
+        };
+        auto enqueue=[&](int i){
+            if(!admission.empty() && ps[i].bidx==0){
+                for(size_t b=0;b<ps[i].bursts.size();b+=2) owe[i]+=ps[i].bursts[b];
+                ok[i]=in[i]=fits(i);
+                if(!ok[i] && admission=="reject"){ ps[i].remaining_time=0; fin++; return; }
+            }
+            (ok[i]? rq : bg).push_back(i);
+            if(dvfs && ok[i] && ps[i].bidx==0){ for(size_t b=0;b<ps[i].bursts.size();b+=2) left[i]+=ps[i].bursts[b]; placed[i]=1; }
+        };
+        auto passes=[&](int l){
+            double f=power.freq[l], acc=0; vector<int> set;
+            for(int j=0;j<n;j++) if(placed[j]) set.push_back(j);
+            sort(set.begin(), set.end(), [&](int a, int b){ return order(a)<order(b); });
+            for(int j: set){
+                acc+=left[j]+f;
+                if(ps[j].deadline>t && f*ps[j].deadline-acc<f*t-1e-9) return false;
+            }
+            return true;
+        };
+        auto govern=[&](int i){
+            int lo=0; while(lo<power.top() && !passes(lo)) lo++;
+            Time room=nextAt(ps)-t, rem=ps[i].remaining_time;
+            int l=power.top(); double best=power.watts[l];
+            for(int k=lo;k<power.top();k++){
+                Time wall=wallAt(ps, i, k), len=min(wall, room);
+                Time work= len==wall? rem : min(rem, (len*speed(k)+part[i])/MICRO);
+                if(len>0 && work>0 && len*power.watts[k]/work<best-1e-12){ best=len*power.watts[k]/work; l=k; }
+            }
+            pstate=l;
+            until=t+min(wallAt(ps, i, l), room);
+        };
+        while(fin<n){
+            arrivals(ps, t, enqueue);
+            if(fin==n) break;
+            vector<int>& q = rq.empty()? bg : rq;
+            if(q.empty()){
+                Time nx=nextAt(ps);
+                if(nx==TIME_MAX) break;
+                idle(t, nx, g); last=-1; continue;
+            }
+            size_t k=argminBy(q, [&](int j){ return make_pair(ps[j].deadline, ps[j].remaining_time); });
+            int i=q[k];
+            if(i!=last){    // an arrival during the switch gets a say before i runs
+                last=i;
+                if(pay(ps, i, t, g)){ if(dvfs) govern(i); continue; }
+            }
+            if(dvfs && t>=until) govern(i);
+            Time before=ps[i].remaining_time;
+            exec(ps, i, 1, t, g);
+            Time done=before-ps[i].remaining_time;
+            if(in[i]) owe[i]-=done;
+            left[i]-=done;
+            if(ps[i].remaining_time==0){
+                q.erase(q.begin()+k); last=-1;
+                if(finish(ps,i,t)) { fin++; in[i]=placed[i]=0; }
+            }
+        }
+        total=t;
+        if(admission=="reject"){
+            vector<Process> kept;
+            for(int i=0;i<n;i++) if(ok[i]) kept.push_back(move(ps[i]));
+            ps.swap(kept);
+        }
+    }
+};
+
+// -------------- Cases --------------
+struct Case{
+    string label, type; SchedConfig cfg;
+    function<unique_ptr<Scheduler>(const SchedConfig&)> ref;
+};
+
+static vector<Case> cases(){
+    SchedConfig base; base.seed=12345; base.groupWeights={{"a",2},{"a/x",1},{"b",3}};
+    SchedConfig wrr=base, drr=base, reject=base, defer=base, steady=base, slow=base;
+    parseMLQClasses("0-1:rr2:3,2-3:sjf:1,4-9:fcfs:2", wrr.mlqClasses); wrr.mlqShare="wrr";
+    drr.mlqClasses=wrr.mlqClasses; drr.mlqShare="drr";
+    reject.admission="reject"; defer.admission="defer";
+    parsePowerModel("0.4,0.6,0.8,1", "", steady.power); steady.power.report=true;
+    slow.power=steady.power; steady.governor="steady"; slow.governor="deadline";
+    auto mlq=[](const SchedConfig& c){ return make_unique<RefMLQ>(c.mlqClasses, c.mlqShare, c.quantum); };
+    vector<Case> all={
+        {"fcfs", "fcfs", base, [](const SchedConfig&){ return nonPreemptive("fcfs", [](const Process&){ return 0; }); }},
+        {"sjf", "sjf", base, [](const SchedConfig&){ return nonPreemptive("sjf", [](const Process& p){ return p.remaining_time; }); }},
+        {"priority", "priority", base, [](const SchedConfig&){
+            return nonPreemptive("priority", [](const Process& p){ return make_pair(p.priority, p.remaining_time); }); }},
+        {"srtf", "srtf", base, [](const SchedConfig&){ return make_unique<RefSRTF>(); }},
+        {"rr", "rr", base, [](const SchedConfig& c){ return make_unique<RefRR>(c.quantum); }},
+        {"mlq", "mlq", base, mlq},
+        {"mlq-wrr", "mlq", wrr, mlq},
+        {"mlq-drr", "mlq", drr, mlq},
+        {"mlfq", "mlfq", base, [](const SchedConfig&){ return make_unique<RefMLFQ>(); }},
+        {"lottery", "lottery", base, [](const SchedConfig& c){ return make_unique<RefLottery>(c.seed); }},
+        {"stride", "stride", base, [](const SchedConfig&){ return make_unique<RefStride>(); }},
+        {"cfs", "cfs", base, [](const SchedConfig& c){ return make_unique<RefCFS>(c.governor); }},
+        {"cfs-steady", "cfs", steady, [](const SchedConfig& c){ return make_unique<RefCFS>(c.governor); }},
+        {"eevdf", "eevdf", base, [](const SchedConfig&){ return make_unique<RefEEVDF>(); }},
+        {"group", "group", base, [](const SchedConfig& c){ return make_unique<RefGroup>(c.groupWeights); }},
+        {"edf", "edf", base, [](const SchedConfig& c){ return make_unique<RefEDF>(c.admission, c.governor); }},
+        {"edf-reject", "edf", reject, [](const SchedConfig& c){ return make_unique<RefEDF>(c.admission, c.governor); }},
+        {"edf-defer", "edf", defer, [](const SchedConfig& c){ return make_unique<RefEDF>(c.admission, c.governor); }},
+        {"edf-deadline", "edf", slow, [](const SchedConfig& c){ return make_unique<RefEDF>(c.admission, c.governor); }},
+    };
+    // every case again with switch, cache and migration costs
+    size_t plain=all.size();
+    for(size_t k=0;k<plain;k++){
+        Case c=all[k]; c.label+="+cost"; c.cfg.cost={2, 3, 10, 5};
+        all.push_back(c);
+    }
+    return all;
+}
+
+// -------------- Workloads --------------
+// Clumps of simultaneous arrivals, idle gaps, the odd long job (so engines take their
+// solo-run shortcuts), I/O on two devices, optional deadlines and nested groups.
+static vector<Process> randomWorkload(mt19937& rng, int n){
+    auto r=[&](int lo, int hi){ return uniform_int_distribution<int>(lo,hi)(rng); };
+    const char* groups[]={"", "a", "a/x", "a/y", "b"};
+    vector<Process> ps; Time at=0;
+    for(int k=0;k<n;k++){
+        at += r(0,3)==0? r(0,40) : r(0,2);
+        Process p{}; p.id="P"+to_string(k+1); p.arrival_time=at; p.priority=r(-1,6);
+        int nb = r(0,3)==0? 2*r(1,2)+1 : 1;
+        for(int b=0;b<nb;b++){
+            Time len = b%2? r(1,12) : r(0,9)==0? r(30,120) : r(1,12);
+            p.bursts.push_back(len);
+            if(b%2) p.devs.push_back(r(0,1)); else p.burst_time+=len;
+        }
+        if(r(0,1)) p.deadline = at + p.burst_time*r(1,4) + r(0,10);
+        p.migrated = r(0,4)==0;
+        p.group=groups[r(0,4)];
+        ps.push_back(p);
+    }
+    return ps;
+}
+// Saturated load for timing: arrivals faster than service, so ready sets grow large.
+static vector<Process> heavyWorkload(mt19937& rng, int n){
+    auto r=[&](int lo, int hi){ return uniform_int_distribution<int>(lo,hi)(rng); };
+    vector<Process> ps; Time at=0;
+    for(int k=0;k<n;k++){
+        at += r(0,4);
+        Process p{}; p.id="P"+to_string(k+1); p.arrival_time=at; p.priority=r(1,6);
+        p.burst_time=r(1,12); p.bursts={p.burst_time};
+        p.deadline = at + p.burst_time*r(2,40);
+        p.group= k%3? "a/x" : "b";
+        ps.push_back(p);
+    }
+    return ps;
+}
+
+// -------------- Comparison --------------
+struct Outcome{ Gantt g; Time total=0; vector<tuple<string,Time,Time,Time>> jobs; double joules=0; };
+
+static Outcome run(Scheduler& s, vector<Process> ps){
+    Outcome o; s.schedule(ps, o.g, o.total); o.joules=s.energy();
+    Gantt m;                                  // merge back-to-back slices of the same job
+    for(auto& sl: o.g) if(sl.second>0){
+        if(!m.empty() && m.back().first==sl.first) m.back().second+=sl.second; else m.push_back(sl);
+    }
+    o.g.swap(m);
+    for(auto& p: ps) o.jobs.emplace_back(p.id, p.turnaround_time, p.waiting_time, p.io_time);
+    sort(o.jobs.begin(), o.jobs.end());
+    return o;
+}
+
+static void dump(const vector<Process>& ps){
+    for(auto& p: ps){
+        cerr<<"  "<<p.id<<" "<<p.arrival_time<<" ";
+        for(size_t b=0;b<p.bursts.size();b++){
+            if(b) cerr<<",";
+            if(b%2 && p.devs[b/2]) cerr<<p.devs[b/2]<<":";
+            cerr<<p.bursts[b];
+        }
+        cerr<<" "<<p.priority;
+        if(p.deadline) cerr<<" "<<p.deadline;
+        if(!p.group.empty()) cerr<<" "<<p.group;
+        cerr<<(p.migrated? "    # migrated\n" : "\n");
+    }
+}
+
+static unique_ptr<Scheduler> reference(const Case& c){ auto r=c.ref(c.cfg); r->cost=c.cfg.cost; r->power=c.cfg.power; return r; }
+
+static bool same(const Case& c, const vector<Process>& ps){
+    auto eng=makeScheduler(c.type, c.cfg); auto ref=reference(c);
+    Outcome a=run(*eng, ps), b=run(*ref, ps);
+    if(a.g==b.g && a.total==b.total && a.jobs==b.jobs && fabs(a.joules-b.joules)<1e-6) return true;
+    size_t k=0; while(k<a.g.size() && k<b.g.size() && a.g[k]==b.g[k]) k++;
+    cerr<<c.label<<": engine and reference disagree";
+    if(a.g!=b.g) cerr<<" at slice "<<k<<": "
+        <<(k<a.g.size()? a.g[k].first+"("+to_string(a.g[k].second)+")" : "end")<<" vs "
+        <<(k<b.g.size()? b.g[k].first+"("+to_string(b.g[k].second)+")" : "end");
+    else if(a.total!=b.total) cerr<<" on total time: "<<a.total<<" vs "<<b.total;
+    else if(a.jobs!=b.jobs) cerr<<" on per-job metrics";
+    else cerr<<" on energy: "<<a.joules<<" vs "<<b.joules;
+    cerr<<"\nworkload:\n"; dump(ps);
+    return false;
+}
+
+// -------------- Energy --------------
+// On a set plain EDF schedules without a miss, the deadline governor may run slower
+// but must never spend more energy than racing at full speed. Returns -1 when the set
+// is not schedulable, else whether the check held.
+static int governorSaves(const vector<Process>& ps){
+    SchedConfig race; parsePowerModel("0.4,0.6,0.8,1", "", race.power); race.power.report=true;
+    SchedConfig slow=race; slow.governor="deadline";
+    auto energy=[&](const SchedConfig& c, bool& late){
+        auto s=makeScheduler("edf", c); vector<Process> q=ps; Gantt g; Time total=0;
+        s->schedule(q, g, total);
+        late=false; for(auto& p: q) late |= p.arrival_time+p.turnaround_time>p.deadline;
+        return s->energy();
+    };
+    bool late; double full=energy(race, late);
+    if(late) return -1;
+    double e=energy(slow, late);
+    if(e<=full+1e-9) return 1;
+    cerr<<"edf deadline governor: energy "<<e<<" above race "<<full<<"\nworkload:\n"; dump(ps);
+    return 0;
+}
+
+template<class F> static double seconds(F f){
+    auto t0=chrono::steady_clock::now(); f();
+    return chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+}
+
+int main(int argc, char** argv){
+    int rounds = argc>1? atoi(argv[1]) : 300;
+    uint32_t seed = argc>2? (uint32_t)strtoul(argv[2],nullptr,10) : 1;
+    const double MIN_SPEEDUP=0.75;       // engines no faster in principle (FCFS, RR) sit near 1x
+    auto all=cases(); int failed=0; vector<char> bad(all.size(),0);
+
+    mt19937 rng(seed); int schedulable=0; bool wasteful=false;
+    for(int r=0;r<rounds;r++){
+        auto ps=randomWorkload(rng, uniform_int_distribution<int>(1, r%10? 12 : 60)(rng));
+        for(size_t k=0;k<all.size();k++) if(!bad[k] && !same(all[k], ps)){ bad[k]=1; failed++; }   // report each engine once
+        if(!wasteful){
+            int v=governorSaves(ps);
+            schedulable += v>=0;
+            if(v==0){ wasteful=true; failed++; }
+        }
+    }
+    cout<<"edf deadline governor vs race: "<<(wasteful? "FAIL" : "ok")<<" on "<<schedulable<<" schedulable sets\n";
+
+    auto heavy=heavyWorkload(rng, 4000);
+    cout<<left<<setw(16)<<"engine"<<right<<setw(12)<<"engine(ms)"<<setw(12)<<"ref(ms)"<<setw(10)<<"speedup"<<"\n";
+    for(size_t k=0;k<all.size();k++){
+        if(bad[k]) continue;
+        const Case& c=all[k];
+        auto eng=makeScheduler(c.type, c.cfg); auto ref=reference(c);
+        Outcome a, b; double te=1e9, tr=1e9;
+        for(int k=0;k<3;k++){ te=min(te, seconds([&]{ a=run(*eng, heavy); })); tr=min(tr, seconds([&]{ b=run(*ref, heavy); })); }
+        bool ok = a.g==b.g && a.jobs==b.jobs && te*MIN_SPEEDUP<=tr;
+        cout<<left<<setw(16)<<c.label<<right<<fixed<<setprecision(2)<<setw(12)<<te*1e3<<setw(12)<<tr*1e3
+            <<setw(9)<<tr/te<<"x"<<(ok? "" : "  FAIL")<<"\n";
+        if(!ok) failed++;
+    }
+    cout<<(failed? "FAILED: " : "ok: ")<<rounds<<" random workloads x "<<all.size()<<" engines, seed "<<seed<<"\n";
+    return failed? 1 : 0;
+}
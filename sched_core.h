@@ -0,0 +1,1453 @@
+// sched_core.h
+// Scheduling core shared by simulator.cpp and the single-policy programs: the process
+// and I/O model, metrics, every Scheduler engine, workload parsing and makeScheduler.
+#pragma once
+#include <bits/stdc++.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+// Simulated time. 64-bit so that long traces at fine resolution cannot wrap.
+using Time = int64_t;
+static const Time TIME_MAX = numeric_limits<Time>::max();
+
+struct Process {
+    string id; Time arrival_time; Time burst_time; int priority;
+    Time remaining_time=0; Time waiting_time=0; Time turnaround_time=0;
+    Time deadline=0;               // for EDF
+    double vruntime=0.0;           // for CFS
+    int qlevel=0;                  // for MLFQ
+    vector<Time> bursts;           // CPU, I/O, CPU, ... (empty = one CPU burst of burst_time)
+    vector<int> devs;              // device serving each I/O burst
+    int bidx=0;                    // index of the current burst
+    Time io_time=0; Time blocked_at=0; // time spent blocked on I/O (incl. device queueing)
+    string group;                  // "tenant/sub" path for group fair share ("" = root)
+    Time last_ran=-1;              // end of the job's latest slice, for the switch cost model
+    bool migrated=false;           // its task last ran on another node (cluster mode)
+    double carry=0;                // DVFS: work done on the current burst not yet taken off remaining_time
+    Time stretch=0;                // DVFS: CPU time beyond the work done (ran slower than full speed)
+};
+
+using Gantt = vector<pair<string,Time>>;
+
+// Observer of a run while the engine produces it (trace export). Times are absolute
+// and never go backwards.
+struct TraceSink{
+    virtual ~TraceSink()=default;
+    // i is the job's index in the engine's process vector, -1 for "IDLE" and "CS"
+    virtual void slice(int i, const string& id, Time start, Time len)=0;
+    virtual void blocked(int i, const string& id, Time start, Time len)=0;   // queued for or using a device
+    virtual void counter(const char* name, Time t, int64_t v)=0;
+};
+
+// -------- I/O device model --------
+// Each device serves its queue FIFO, one request at a time, for the length of the
+// I/O burst. Requests are submitted in nondecreasing time order, so a device's queue
+// is fully described by when it frees up; completions wait in a min-heap.
+// The model also carries the run's trace sink, if any, and the runnable-job count
+// reported to it.
+struct IOModel{
+    struct Device{ Time free_at=0; vector<pair<Time,Time>> spans; };   // busy [start,end)
+    vector<Device> dev;
+    priority_queue<pair<Time,int>, vector<pair<Time,int>>, greater<pair<Time,int>>> pending; // (done, idx)
+    TraceSink* trace=nullptr;      // survives reset()
+    int64_t runnable=0;            // jobs the engine holds as ready or running
+
+    void reset(const vector<Process>& ps){
+        int nd=0; for(auto& p: ps) for(int d: p.devs) nd=max(nd, d+1);
+        dev.assign(nd, Device{}); pending=decltype(pending)(); runnable=0;
+    }
+    void count(Time t, int d){ if(trace) trace->counter("runnable", t, runnable+=d); }
+    // p.bidx points at an I/O burst; p blocks at time t until the device completes it.
+    void submit(Process& p, int i, Time t){
+        Device& d=dev[p.devs[p.bidx/2]];
+        Time start=max(t, d.free_at); d.free_at=start+p.bursts[p.bidx];
+        if(!d.spans.empty() && d.spans.back().second==start) d.spans.back().second=d.free_at;
+        else d.spans.push_back({start, d.free_at});
+        p.blocked_at=t; pending.push({d.free_at, i});
+        if(trace) trace->blocked(i, p.id, t, d.free_at-t);
+    }
+    bool due(Time t) const { return !pending.empty() && pending.top().first<=t; }
+    Time nextTime() const { return pending.empty()? TIME_MAX : pending.top().first; }
+    // Completes the earliest I/O and readies its process for the next CPU burst.
+    int wake(vector<Process>& ps){
+        auto [t,i]=pending.top(); pending.pop();
+        Process& p=ps[i]; p.io_time+=t-p.blocked_at; p.bidx++; p.remaining_time=p.bursts[p.bidx];
+        return i;
+    }
+};
+
+// Slices that are neither idle time nor switch overhead.
+inline bool isWork(const string& id){ return id!="IDLE" && id!="CS"; }
+
+inline void printGantt(const Gantt& g){
+    cout << "Gantt: ";
+    for (auto& e: g) cout << e.first << "(" << e.second << ") ";
+    cout << "\n";
+}
+// Sums are kept in 128 bits: millions of jobs times month-long µs turnarounds overflow int64.
+inline void calcMetrics(vector<Process>& ps, Time total_time, const Gantt& g,
+                        double& avg_wait, double& avg_turn, double& cpu, double& thr){
+    __int128 aw=0, at=0; Time busy=0;
+    for (auto& p: ps){ aw += p.waiting_time; at += p.turnaround_time; }
+    for (auto& e: g) if(isWork(e.first)) busy += e.second;
+    int n = (int)ps.size();
+    avg_wait = n? (double)aw/n : 0; avg_turn = n? (double)at/n : 0;
+    cpu = total_time? (100.0*busy/total_time) : 0.0;
+    thr = total_time? (double)n/total_time : 0.0;
+}
+// Share of the run with at least one device busy, and with the CPU and a device busy at once.
+inline void ioMetrics(const Gantt& g, const IOModel& io, Time total_time, double& io_util, double& overlap){
+    vector<pair<Time,Time>> sp, u;
+    for (auto& d: io.dev) sp.insert(sp.end(), d.spans.begin(), d.spans.end());
+    sort(sp.begin(), sp.end());
+    for (auto& s: sp){
+        if(!u.empty() && s.first<=u.back().second) u.back().second=max(u.back().second, s.second);
+        else u.push_back(s);
+    }
+    Time busy=0, both=0, t=0; size_t k=0;
+    for (auto& s: u) busy += s.second-s.first;
+    for (auto& e: g){
+        Time a=t, b=t+e.second; t=b;
+        if(!isWork(e.first)) continue;
+        while(k<u.size() && u[k].second<=a) k++;
+        for(size_t j=k; j<u.size() && u[j].first<b; j++) both += min(b,u[j].second)-max(a,u[j].first);
+    }
+    io_util = total_time? (100.0*busy/total_time) : 0.0;
+    overlap = total_time? (100.0*both/total_time) : 0.0;
+}
+inline void printResults(vector<Process>& ps, Time total_time, const Gantt& g, const IOModel& io){
+    double aw,at,cpu,thr; calcMetrics(ps,total_time,g,aw,at,cpu,thr);
+    printGantt(g);
+    cout<<fixed<<setprecision(2);
+    cout<<"Average Waiting Time: "<<aw<<"\n";
+    cout<<"Average Turnaround Time: "<<at<<"\n";
+    cout<<"CPU Utilization: "<<cpu<<"%\n";
+    Time cs=0; size_t switches=0;
+    for(auto& e: g) if(e.first=="CS"){ cs+=e.second; switches++; }
+    if(switches) cout<<"Switch Overhead: "<<cs<<" ("<<(total_time? 100.0*cs/total_time : 0.0)<<"% of time, "<<switches<<" switches)\n";
+    if(!io.dev.empty()){
+        double iou,ov; ioMetrics(g,io,total_time,iou,ov);
+        cout<<"I/O Utilization: "<<iou<<"%\n";
+        cout<<"CPU/I-O Overlap: "<<ov<<"%\n";
+    }
+    cout<<"Throughput: "<<thr<<" processes/unit time\n";
+}
+
+// Cost of handing the CPU to a job, charged as a "CS" slice. Any switch costs cswitch.
+// A job resuming also reloads its working set: warm when it has been off the CPU for
+// decay or longer, proportionally less after a shorter gap. A first run pays migrate
+// instead when its task last ran on another node. All zero means free switches.
+struct CostModel{
+    Time cswitch=0, warm=0, decay=100, migrate=0;
+    bool on() const { return cswitch>0 || warm>0 || migrate>0; }
+};
+
+// CPU frequency and power. P-states run from slowest to fastest, with frequencies
+// relative to the fastest; a burst of b units takes b/f at frequency f. Power is per
+// unit of time, so energy is power x time in the same units.
+struct PowerModel{
+    vector<double> freq{1.0}, watts{1.0};
+    double idle=0.05;              // power with nothing to run
+    bool report=false;             // a DVFS option was given: print the energy lines
+    int top() const { return (int)freq.size()-1; }
+    // Slowest P-state at least f fast (the fastest if none is).
+    int atLeast(double f) const { for(int l=0;l<top();l++) if(freq[l]>=f-1e-9) return l; return top(); }
+};
+
+// P-states "F[:W],..." and the curve "STATIC,DYNAMIC[,IDLE]" that prices the states given
+// without W as P(f) = STATIC + DYNAMIC*f^3, e.g. "0.5,0.75:0.4,1" with "0.1,0.9,0.05".
+inline bool parsePowerModel(const string& pstates, const string& curve, PowerModel& pm){
+    double st=0.1, dyn=0.9; pm.idle=0.05;
+    try{
+        vector<double> c; istringstream cs(curve);
+        for(string tok; getline(cs,tok,','); ) c.push_back(stod(tok));
+        if(c.size()>3 || (!curve.empty() && c.size()<2)) return false;
+        if(c.size()>=2){ st=c[0]; dyn=c[1]; }
+        if(c.size()==3) pm.idle=c[2];
+        vector<pair<double,double>> lv; istringstream ss(pstates);
+        for(string tok; getline(ss,tok,','); ){
+            size_t k=tok.find(':');
+            double f=stod(tok.substr(0,k)), w= k==string::npos? -1 : stod(tok.substr(k+1));
+            if(f<=0 || (k!=string::npos && w<0)) return false;
+            lv.push_back({f,w});
+        }
+        if(lv.empty()) return false;
+        sort(lv.begin(), lv.end());
+        double fmax=lv.back().first;
+        pm.freq.clear(); pm.watts.clear();
+        for(auto [f,w]: lv){
+            f/=fmax;
+            if(!pm.freq.empty() && f-pm.freq.back()<1e-9) return false;   // duplicate state
+            pm.freq.push_back(f); pm.watts.push_back(w>=0? w : st+dyn*f*f*f);
+        }
+    }catch(...){ return false; }
+    return st>=0 && dyn>=0 && pm.idle>=0;
+}
+
+class Scheduler{
+public:
+    virtual ~Scheduler()=default;
+    virtual string name() const = 0;
+    virtual void schedule(vector<Process>& ps, Gantt& g, Time& total_time)=0;
+    IOModel io;                    // devices for blocking bursts; reset by schedule()
+    CostModel cost;
+    PowerModel power;
+    vector<Time> busyAt; Time idleTime=0;   // time spent at each P-state and idle
+    virtual void printStats() const {}   // policy-specific lines after the common metrics
+    double energy() const {
+        double e=idleTime*power.idle;
+        for(size_t l=0;l<busyAt.size();l++) e+=busyAt[l]*power.watts[l];
+        return e;
+    }
+protected:
+    int level=-1;                  // current P-state, -1 = the fastest (no governor)
+    int lvl() const { return level<0? power.top() : level; }
+    void setLevel(int l, Time t){
+        if(l==lvl()) return;
+        level=l;
+        if(io.trace) io.trace->counter("freq %", t, llround(power.freq[l]*100));
+    }
+    // Time job p needs to finish its burst at the current P-state. At full speed work
+    // is whole units again: running there drops any fraction carried from a slow slice.
+    Time wallFor(const Process& p) const {
+        double f=power.freq[lvl()];
+        if(f>=1) return p.remaining_time;
+        return max<Time>(1, (Time)ceil((p.remaining_time-p.carry)/f-1e-9));
+    }
+    // Work p gets done in len time at the current P-state; fractions of a unit carry
+    // over to its next slice of the same burst. A step of no length (cut short by an
+    // arrival during the switch) leaves the carry alone.
+    Time workIn(Process& p, Time len) const {
+        double f=power.freq[lvl()];
+        if(f>=1){ if(len) p.carry=0; return len; }
+        double w=len*f+p.carry; Time done=min(p.remaining_time, (Time)floor(w+1e-9));
+        p.carry= done==p.remaining_time? 0 : w-done; p.stretch+=len-done;
+        return done;
+    }
+    // Every slice goes through here: into the Gantt chart, the energy account and the
+    // trace, if any.
+    void record(Gantt& g, int i, const string& id, Time start, Time len){
+        g.push_back({id, len});
+        if(i<0 && id=="IDLE") idleTime+=len;
+        else { if(busyAt.empty()) busyAt.assign(power.freq.size(), 0); busyAt[lvl()]+=len; }
+        if(io.trace) io.trace->slice(i, id, start, len);
+    }
+    void idleUntil(Time& cur, Time to, Gantt& g){ if(to>cur){ record(g, -1, "IDLE", cur, to-cur); cur=to; } }
+    // What handing the CPU to job i at t costs: nothing if it already holds it.
+    Time switchCost(const vector<Process>& ps, int i, Time t, const Gantt& g) const {
+        const Process& p=ps[i];
+        if(!cost.on() || (!g.empty() && g.back().first==p.id)) return 0;
+        Time c=cost.cswitch;
+        if(p.last_ran>=0) c += cost.decay>0? cost.warm*min(t-p.last_ran, cost.decay)/cost.decay : cost.warm;
+        else if(p.migrated) c += cost.migrate;
+        return c;
+    }
+    // Job i is about to run at t: pay for the switch. A solo run is measured from the
+    // end of it (t+switchCost).
+    void charge(vector<Process>& ps, int i, Time& t, Gantt& g){
+        if(Time c=switchCost(ps, i, t, g)){ record(g, -1, "CS", t, c); t+=c; }
+    }
+    void runSlice(vector<Process>& ps, int i, Time len, Time& t, Gantt& g){
+        charge(ps, i, t, g);
+        record(g, i, ps[i].id, t, len); t+=len; ps[i].remaining_time-=workIn(ps[i], len); ps[i].last_ran=t;
+    }
+};
+
+// Energy lines, printed when a DVFS option is given. Deadline misses count the jobs that
+// carry a deadline (EDF reports its own).
+inline void printEnergy(const Scheduler& s, const vector<Process>& ps, Time total){
+    double e=s.energy(); Time busy=accumulate(s.busyAt.begin(), s.busyAt.end(), (Time)0);
+    cout<<fixed<<setprecision(2);
+    cout<<"Energy: "<<e<<" (idle "<<s.idleTime*s.power.idle<<")\n";
+    cout<<"Average Power: "<<(total? e/total : 0.0)<<"\n";
+    cout<<"Energy-Delay Product: "<<e*total<<"\n";
+    cout<<"Frequency Residency:";
+    for(size_t l=0;l<s.busyAt.size();l++) cout<<" "<<s.power.freq[l]<<"="<<(busy? 100.0*s.busyAt[l]/busy : 0.0)<<"%";
+    cout<<"\n";
+    if(s.name()!="edf"){
+        size_t due=0, late=0;
+        for(auto& p: ps) if(p.deadline){ due++; late += p.arrival_time+p.turnaround_time>p.deadline; }
+        if(due) cout<<"Deadline Misses: "<<late<<" of "<<due<<"\n";
+    }
+}
+
+// -------- shared helpers --------
+inline void ensureRemaining(vector<Process>& ps){
+    for(auto& p: ps){
+        if(p.bursts.empty()) p.bursts={p.burst_time};
+        p.bidx=0; p.io_time=0; p.remaining_time=p.bursts[0]; p.last_ran=-1; p.carry=0; p.stretch=0;
+    }
+}
+inline void sortByArrival(vector<Process>& ps){
+    sort(ps.begin(), ps.end(), [](const Process&a, const Process&b){return a.arrival_time<b.arrival_time;});
+}
+inline Time nextArrivalAfter(const vector<Process>& ps, Time t, const IOModel& io){
+    Time nx=io.nextTime(); for (auto& p: ps) if(p.remaining_time>0 && p.arrival_time>t) nx=min(nx, p.arrival_time);
+    return (nx==TIME_MAX)? t : nx;
+}
+
+// Hands every process that is ready by time t to push(), in time order: new arrivals
+// (ps sorted by arrival, cursor nextIdx) merged with I/O wakeups.
+template<class F>
+inline void admit(vector<Process>& ps, int& nextIdx, IOModel& io, Time t, F push){
+    int n=ps.size();
+    for(;;){
+        bool a = nextIdx<n && ps[nextIdx].arrival_time<=t, w = io.due(t);
+        if(a && (!w || ps[nextIdx].arrival_time<=io.nextTime())) push(nextIdx++);
+        else if(w) push(io.wake(ps));
+        else break;
+        io.count(t, 1);
+    }
+}
+inline Time nextEvent(const vector<Process>& ps, int nextIdx, const IOModel& io){
+    return min(nextIdx<(int)ps.size()? ps[nextIdx].arrival_time : TIME_MAX, io.nextTime());
+}
+// Length to run a job that has nobody else ready: it keeps winning quantum q until the
+// next arrival or wakeup, so grant all of those quanta in one slice.
+inline Time soloRun(Time q, Time rem, Time t, Time next){
+    if(next==TIME_MAX) return rem;
+    return min(rem, max<Time>(1, (next-t+q-1)/q)*q);
+}
+// Virtual time in closed form: base + ran/w, where ran is the CPU had since the last
+// rebase. Slices only add to the integer ran, so one solo run of many quanta lands on
+// exactly the value the separate quanta would, in O(1).
+struct VClock{
+    double base=0; Time ran=0;
+    double at(double w) const { return ran? base+ran/w : base; }
+    void rebase(double v){ base=v; ran=0; }
+};
+inline int tickets(const Process& p){ return max(1, 10 / max(1, p.priority)); }
+
+// Measures each job's CPU against its ideal proportional share: tickets / ready tickets,
+// integrated over the time the job is ready. vt is that integral per ticket, so every
+// join, leave and slice is O(1).
+struct ShareTracker{
+    vector<double> ideal, vjoin; vector<Time> got; double vt=0; long long readyTickets=0;
+    void reset(int n){ ideal.assign(n,0); vjoin.assign(n,0); got.assign(n,0); vt=0; readyTickets=0; }
+    void join(int i, int tk){ vjoin[i]=vt; readyTickets+=tk; }
+    void leave(int i, int tk){ ideal[i]+=tk*(vt-vjoin[i]); readyTickets-=tk; }
+    void run(int i, Time d){ got[i]+=d; if(readyTickets) vt+=(double)d/readyTickets; }
+    // Largest and mean |received - ideal| over all jobs, in time units.
+    void summary(double& maxErr, double& meanErr) const {
+        maxErr=0; meanErr=0;
+        for(size_t i=0;i<got.size();i++){ double e=fabs(got[i]-ideal[i]); maxErr=max(maxErr,e); meanErr+=e; }
+        if(!got.empty()) meanErr/=got.size();
+    }
+};
+
+// ps[i] drained its current CPU burst at time t. Either it is finished (returns true)
+// or it blocks on its next I/O burst until io wakes it.
+inline bool endBurst(vector<Process>& ps, int i, Time t, IOModel& io){
+    Process& p=ps[i]; io.count(t, -1); p.carry=0;
+    if(p.bidx+1>=(int)p.bursts.size()){
+        p.turnaround_time=t-p.arrival_time;
+        p.waiting_time=p.turnaround_time-p.burst_time-p.stretch-p.io_time;
+        return true;
+    }
+    p.bidx++; p.remaining_time=0; io.submit(p,i,t);
+    return false;
+}
+
+// -------- ready-set selection --------
+// Argmin over contiguous key columns masked by a live bitmap (bit i set = entry i is
+// ready), optionally with a secondary tie key. Remaining ties go to the lowest index,
+// i.e. the earliest arrival. The scans run with AVX2 when the CPU has it; large ready
+// sets switch to a lazily-invalidated heap.
+inline int SELECT_CROSSOVER=256;   // ready-set size at which ReadySet switches to a heap
+
+inline bool liveBit(const uint64_t* live, int i){ return live[i>>6]>>(i&63)&1; }
+
+// Scalar kernels: smallest key under mask / mask narrowed to key==v / first key==v under mask.
+template<class K>
+inline K minScalar(const K* key, const uint64_t* mask, int n){
+    K mn=numeric_limits<K>::max();
+    for(int w=0; w*64<n; w++) for(uint64_t m=mask[w]; m; m&=m-1) mn=min(mn, key[w*64+__builtin_ctzll(m)]);
+    return mn;
+}
+template<class K>
+inline void narrowScalar(const K* key, K v, const uint64_t* in, uint64_t* out, int n){
+    for(int w=0; w*64<n; w++){
+        uint64_t r=0;
+        for(uint64_t m=in[w]; m; m&=m-1){ int b=__builtin_ctzll(m); if(key[w*64+b]==v) r|=1ULL<<b; }
+        out[w]=r;
+    }
+}
+template<class K>
+inline int firstScalar(const K* key, K v, const uint64_t* mask, int n){
+    for(int w=0; w*64<n; w++) for(uint64_t m=mask[w]; m; m&=m-1){ int i=w*64+__builtin_ctzll(m); if(key[i]==v) return i; }
+    return -1;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Lanes holding masked-in entries for the 4 keys starting at i.
+__attribute__((target("avx2"))) inline __m256i laneMask(const uint64_t* mask, int i){
+    const __m256i bit=_mm256_setr_epi64x(1,2,4,8);
+    __m256i m=_mm256_set1_epi64x((long long)(mask[i>>6]>>(i&63)&0xF));
+    return _mm256_cmpeq_epi64(_mm256_and_si256(m,bit), bit);
+}
+__attribute__((target("avx2"))) inline __m256i lanesEq(const int64_t* key, int i, int64_t v){
+    return _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(key+i)), _mm256_set1_epi64x(v));
+}
+__attribute__((target("avx2"))) inline __m256i lanesEq(const double* key, int i, double v){
+    return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(key+i), _mm256_set1_pd(v), _CMP_EQ_OQ));
+}
+
+__attribute__((target("avx2")))
+inline int64_t minAVX2(const int64_t* key, const uint64_t* mask, int n){
+    const __m256i inf=_mm256_set1_epi64x(INT64_MAX);
+    __m256i best=inf; int i=0; int64_t mn=INT64_MAX;
+    for(; i+4<=n; i+=4){
+        if(!(i&63) && !mask[i>>6]){ i+=60; continue; }     // skip an empty word whole
+        if(!(mask[i>>6]>>(i&63)&0xF)) continue;
+        __m256i v=_mm256_blendv_epi8(inf, _mm256_loadu_si256((const __m256i*)(key+i)), laneMask(mask,i));
+        best=_mm256_blendv_epi8(best, v, _mm256_cmpgt_epi64(best, v));
+    }
+    alignas(32) int64_t lane[4]; _mm256_store_si256((__m256i*)lane, best);
+    for(int l=0;l<4;l++) mn=min(mn, lane[l]);
+    for(; i<n; i++) if(liveBit(mask,i)) mn=min(mn, key[i]);
+    return mn;
+}
+__attribute__((target("avx2")))
+inline double minAVX2(const double* key, const uint64_t* mask, int n){
+    const __m256d inf=_mm256_set1_pd(numeric_limits<double>::max());
+    __m256d best=inf; int i=0; double mn=numeric_limits<double>::max();
+    for(; i+4<=n; i+=4){
+        if(!(i&63) && !mask[i>>6]){ i+=60; continue; }
+        if(!(mask[i>>6]>>(i&63)&0xF)) continue;
+        best=_mm256_min_pd(best, _mm256_blendv_pd(inf, _mm256_loadu_pd(key+i), _mm256_castsi256_pd(laneMask(mask,i))));
+    }
+    alignas(32) double lane[4]; _mm256_store_pd(lane, best);
+    for(int l=0;l<4;l++) mn=min(mn, lane[l]);
+    for(; i<n; i++) if(liveBit(mask,i)) mn=min(mn, key[i]);
+    return mn;
+}
+template<class K> __attribute__((target("avx2")))
+inline void narrowAVX2(const K* key, K v, const uint64_t* in, uint64_t* out, int n){
+    int i=0;
+    for(int w=0; w*64<n; w++) out[w]=0;
+    for(; i+4<=n; i+=4){
+        if(!(i&63) && !in[i>>6]){ i+=60; continue; }
+        uint64_t m=in[i>>6]>>(i&63)&0xF; if(!m) continue;
+        out[i>>6] |= (uint64_t)(_mm256_movemask_pd(_mm256_castsi256_pd(lanesEq(key,i,v))) & m) << (i&63);
+    }
+    for(; i<n; i++) if(liveBit(in,i) && key[i]==v) out[i>>6] |= 1ULL<<(i&63);
+}
+template<class K> __attribute__((target("avx2")))
+inline int firstAVX2(const K* key, K v, const uint64_t* mask, int n){
+    int i=0;
+    for(; i+4<=n; i+=4){
+        if(!(i&63) && !mask[i>>6]){ i+=60; continue; }
+        uint64_t m=mask[i>>6]>>(i&63)&0xF; if(!m) continue;
+        int bits=_mm256_movemask_pd(_mm256_castsi256_pd(lanesEq(key,i,v))) & m;
+        if(bits) return i+__builtin_ctz(bits);
+    }
+    for(; i<n; i++) if(liveBit(mask,i) && key[i]==v) return i;
+    return -1;
+}
+static const bool HAS_AVX2=__builtin_cpu_supports("avx2");
+#else
+static const bool HAS_AVX2=false;
+template<class K> inline K minAVX2(const K* key, const uint64_t* mask, int n){ return minScalar(key,mask,n); }
+template<class K> inline void narrowAVX2(const K* key, K v, const uint64_t* in, uint64_t* out, int n){ narrowScalar(key,v,in,out,n); }
+template<class K> inline int firstAVX2(const K* key, K v, const uint64_t* mask, int n){ return firstScalar(key,v,mask,n); }
+#endif
+
+template<class K>
+class ReadySet{
+    vector<K> key, tie; vector<uint64_t> live, sel; int n=0, nlive=0; bool compound=false, useHeap=false;
+    priority_queue<tuple<K,K,int>, vector<tuple<K,K,int>>, greater<tuple<K,K,int>>> heap;  // lazy: may hold stale keys
+    void rebuild(){
+        heap=decltype(heap)();
+        for(int i=0;i<n;i++) if(liveBit(live.data(),i)) heap.push({key[i],tie[i],i});
+    }
+    K minOf(const vector<K>& k, const uint64_t* m) const { return HAS_AVX2? minAVX2(k.data(),m,n) : minScalar(k.data(),m,n); }
+    int firstOf(const vector<K>& k, K v, const uint64_t* m) const { return HAS_AVX2? firstAVX2(k.data(),v,m,n) : firstScalar(k.data(),v,m,n); }
+public:
+    // compound: break key ties on the secondary key passed to put().
+    void reset(int count, bool withTie=false){
+        n=count; compound=withTie; key.assign(n,K{}); tie.assign(n,K{}); live.assign(n/64+1,0); sel.assign(n/64+1,0);
+        nlive=0; useHeap=false; heap=decltype(heap)();
+    }
+    int size() const { return nlive; }
+    bool has(int i) const { return liveBit(live.data(),i); }
+    const K& at(int i) const { return key[i]; }
+    // Inserts i or changes its key.
+    void put(int i, K k, K t=K{}){
+        if(!has(i)){ live[i>>6]|=1ULL<<(i&63); nlive++; }
+        key[i]=k; tie[i]=t;
+        if(useHeap){ heap.push({k,t,i}); if((int)heap.size()>4*nlive+64) rebuild(); }
+        else if(nlive>=SELECT_CROSSOVER){ useHeap=true; rebuild(); }
+    }
+    void drop(int i){
+        if(!has(i)) return;
+        live[i>>6]&=~(1ULL<<(i&63)); nlive--;
+        if(useHeap && nlive<SELECT_CROSSOVER/2){ useHeap=false; heap=decltype(heap)(); }
+    }
+    // Index with the smallest (key, tie), or -1 when empty.
+    int argmin(){
+        if(!nlive) return -1;
+        if(useHeap){
+            for(;;){
+                auto [k,t,i]=heap.top();
+                if(has(i) && key[i]==k && tie[i]==t) return i;
+                heap.pop();
+            }
+        }
+        K mn=minOf(key, live.data());
+        if(!compound) return firstOf(key, mn, live.data());
+        if(HAS_AVX2) narrowAVX2(key.data(), mn, live.data(), sel.data(), n);
+        else narrowScalar(key.data(), mn, live.data(), sel.data(), n);
+        return firstOf(tie, minOf(tie, sel.data()), sel.data());
+    }
+};
+
+// ================= implementations =================
+
+// FCFS
+class FCFSScheduler: public Scheduler{
+public: string name() const override { return "fcfs"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        int n=ps.size(), nextIdx=0, fin=0; Time t=0; queue<int> rq;
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, [&](int i){ rq.push(i); }); };
+        arrive();
+        while(fin<n){
+            if(rq.empty()){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int i=rq.front(); rq.pop();
+            Time run=ps[i].remaining_time;
+            runSlice(ps, i, run, t, g);
+            if(endBurst(ps,i,t,io)) fin++;
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// SJF (non-preemptive, on the length of the next CPU burst)
+class SJFScheduler: public Scheduler{
+public: string name() const override { return "sjf"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        int n=ps.size(), nextIdx=0, done=0; Time t=0;
+        ReadySet<Time> rs; rs.reset(n);                    // key: length of the burst
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, [&](int i){ rs.put(i, ps[i].remaining_time); }); };
+        arrive();
+        while(done<n){
+            int idx=rs.argmin();
+            if(idx==-1){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            rs.drop(idx);
+            runSlice(ps, idx, ps[idx].remaining_time, t, g);
+            if(endBurst(ps,idx,t,io)) done++;
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// SRTF
+class SRTFScheduler: public Scheduler{
+public: string name() const override { return "srtf"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        int n=ps.size(), nextIdx=0, finished=0; Time t=0; int run=-1; Time runlen=0;   // run: job on the CPU, -1 = idle
+        ReadySet<Time> rs; rs.reset(n);                    // key: remaining time
+        auto flush=[&](){ if(runlen>0){ record(g, run, run<0? "IDLE" : ps[run].id, t-runlen, runlen); runlen=0; } };
+        while(finished<n){
+            admit(ps, nextIdx, io, t, [&](int i){ rs.put(i, ps[i].remaining_time); });
+            int idx=rs.argmin();
+            if(idx==-1){
+                Time nx=nextEvent(ps,nextIdx,io);
+                if(run>=0){ flush(); run=-1; }
+                runlen+=max<Time>(0,nx-t); t=nx; continue;
+            }
+            if(run!=idx){ flush(); run=idx; charge(ps, idx, t, g); }
+            // nothing can preempt before the next arrival or wakeup, so run straight to it
+            // (an arrival during the switch itself gets a say first)
+            Time step=max<Time>(0, min(ps[idx].remaining_time, nextEvent(ps,nextIdx,io)-t));
+            ps[idx].remaining_time-=step; runlen+=step; t+=step; if(step) ps[idx].last_ran=t;
+            if(ps[idx].remaining_time==0){
+                rs.drop(idx); flush();
+                if(endBurst(ps,idx,t,io)) finished++;
+                run=-1;
+            } else rs.put(idx, ps[idx].remaining_time);
+        }
+        total=t;
+    }
+};
+
+// Priority (non-preemptive, lower number = higher priority) with simple aging
+// Each aging step lowers every ready job's priority by one, floored at 0. Instead of
+// touching every job, a ready job is keyed on its priority plus the steps taken before
+// it joined, and jobs whose key the step count catches up with move to a set at
+// priority 0 ordered by burst length alone.
+class PriorityNPScheduler: public Scheduler{
+public: string name() const override { return "priority"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        const int AGE_STEP=5;
+        int n=ps.size(), nextIdx=0, done=0; Time t=0, last_age=0, aged=0;
+        vector<Time> key(n);
+        ReadySet<Time> rs; rs.reset(n, true);              // key: priority + aged at join, then burst length
+        ReadySet<Time> floor0; floor0.reset(n);            // aged down to 0; key: burst length
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, [&](int i){
+            key[i]=ps[i].priority+aged;
+            if(ps[i].priority==0) floor0.put(i, ps[i].remaining_time); else rs.put(i, key[i], ps[i].remaining_time);
+        }); };
+        arrive();
+        while(done<n){
+            if(t-last_age>=AGE_STEP){
+                aged++; last_age=t;
+                for(int i; (i=rs.argmin())!=-1 && key[i]<=aged; ){ rs.drop(i); floor0.put(i, ps[i].remaining_time); }
+            }
+            // a negative priority not yet aged still beats the floor
+            int idx=rs.argmin();
+            if(floor0.size() && (idx==-1 || key[idx]>=aged)) idx=floor0.argmin();
+            if(idx==-1){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            if(floor0.has(idx)){ floor0.drop(idx); ps[idx].priority=0; }
+            else { rs.drop(idx); ps[idx].priority=(int)(key[idx]-aged); }
+            runSlice(ps, idx, ps[idx].remaining_time, t, g);
+            if(endBurst(ps,idx,t,io)) done++;
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// Round Robin
+class RRScheduler: public Scheduler{
+    int q;
+public:
+    explicit RRScheduler(int quantum): q(quantum) {}
+    string name() const override { return "rr"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        int n=ps.size(), nextIdx=0, fin=0; Time t=0; queue<int> rq;
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, [&](int i){ rq.push(i); }); };
+        arrive();
+        while(fin<n){
+            if(rq.empty()){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int i=rq.front(); rq.pop();
+            Time slice=rq.empty()? soloRun(q, ps[i].remaining_time, t+switchCost(ps, i, t, g), nextEvent(ps,nextIdx,io))
+                                 : min<Time>(q, ps[i].remaining_time);
+            runSlice(ps, i, slice, t, g);
+            if(ps[i].remaining_time==0 && endBurst(ps,i,t,io)) fin++;
+            arrive();
+            if(ps[i].remaining_time>0) rq.push(i);
+        }
+        total=t;
+    }
+};
+
+// MLQ: jobs are bound by priority to one of N classes, each with its own discipline
+// (RR with a quantum, FCFS or SJF; the latter two never preempt inside the class).
+// Classes share the CPU by
+//   strict  the first listed class with ready work runs; the others may starve
+//   wrr     classes take turns, each turn lasting weight*slot
+//   drr     deficit round robin: each turn adds weight*slot credit and a class runs its
+//           next slice only once the credit covers it, so whole FCFS/SJF bursts still
+//           get a weight-proportional share over time
+// Default: priority<=2 -> RR q=4, the rest FCFS, strict.
+struct MLQClass{ int lo=INT_MIN, hi=INT_MAX; char disc='f'; Time quantum=0; int weight=1; };
+
+// "LO-HI:DISC[:WEIGHT],..." with DISC = fcfs | sjf | rrQ, e.g. "0-2:rr4:3,3-9:fcfs:1".
+// A job whose priority is in no range goes to the last class.
+inline bool parseMLQClasses(const string& spec, vector<MLQClass>& out){
+    out.clear(); istringstream ss(spec); string tok;
+    while(getline(ss,tok,',')){
+        MLQClass c; string range, disc, w="1"; istringstream ts(tok);
+        if(!getline(ts,range,':') || !getline(ts,disc,':')) return false;
+        getline(ts,w);
+        try{
+            size_t dash=range.find('-',1);
+            c.lo=stoi(range.substr(0,dash)); c.hi= dash==string::npos? c.lo : stoi(range.substr(dash+1));
+            c.weight=stoi(w);
+            if(disc=="fcfs") c.disc='f';
+            else if(disc=="sjf") c.disc='s';
+            else if(disc.rfind("rr",0)==0){ c.disc='r'; c.quantum= disc.size()>2? stoll(disc.substr(2)) : 4; }
+            else return false;
+        }catch(...){ return false; }
+        if(c.lo>c.hi || c.weight<1 || (c.disc=='r' && c.quantum<1)) return false;
+        out.push_back(c);
+    }
+    return !out.empty();
+}
+
+class MLQScheduler: public Scheduler{
+    vector<MLQClass> cls; string share; Time slot;
+    vector<size_t> jobs; vector<Time> cpu, maxWait; vector<double> wait; Time busy=0;
+public:
+    MLQScheduler(vector<MLQClass> c, string sh, Time s): cls(move(c)), share(move(sh)), slot(s) {
+        if(cls.empty()) cls={ {INT_MIN,2,'r',4,1}, {3,INT_MAX,'f',0,1} };
+    }
+    string name() const override { return "mlq"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        int n=ps.size(), nc=cls.size(), nextIdx=0, fin=0, ready=0, turn=0; Time t=0;
+        vector<int> of(n, nc-1);
+        for(int i=0;i<n;i++) for(int c=0;c<nc;c++) if(ps[i].priority>=cls[c].lo && ps[i].priority<=cls[c].hi){ of[i]=c; break; }
+        vector<deque<int>> q(nc);                       // RR and FCFS queues
+        vector<ReadySet<Time>> sj(nc);                  // SJF, key: length of the burst
+        vector<int> cur(nc,-1);                         // FCFS/SJF job part-way through its burst
+        vector<Time> credit(nc,0);                      // wrr: time left in the turn; drr: deficit
+        for(int c=0;c<nc;c++) if(cls[c].disc=='s') sj[c].reset(n);
+        credit[0]=(Time)cls[0].weight*slot;
+        cpu.assign(nc,0); busy=0;
+
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, [&](int i){
+            int c=of[i]; ready++;
+            if(cls[c].disc=='s') sj[c].put(i, ps[i].remaining_time); else q[c].push_back(i);
+        }); };
+        auto empty=[&](int c){ return cur[c]<0 && (cls[c].disc=='s'? !sj[c].size() : q[c].empty()); };
+        auto head=[&](int c){ return cur[c]>=0? cur[c] : cls[c].disc=='s'? sj[c].argmin() : q[c].front(); };
+        auto want=[&](int c){ int i=head(c); return cls[c].disc=='r'? min(cls[c].quantum, ps[i].remaining_time) : ps[i].remaining_time; };
+        auto grant=[&](int c){ return (Time)cls[c].weight*slot; };
+        auto pickClass=[&]()->int{
+            if(!ready) return -1;
+            if(share=="strict"){ for(int c=0;c<nc;c++) if(!empty(c)) return c; }
+            for(int visits=1;;visits++){
+                if(empty(turn)) credit[turn]=0;
+                else if(share=="wrr"? credit[turn]>0 : want(turn)<=credit[turn]) return turn;
+                if(visits%nc==0 && share=="drr"){
+                    // nobody could afford its next slice all round: add the rounds of credit
+                    // that still leave someone short at once instead of cycling through them
+                    Time k=TIME_MAX;
+                    for(int c=0;c<nc;c++) if(!empty(c)) k=min(k, (want(c)-credit[c]+grant(c)-1)/grant(c));
+                    for(int c=0;c<nc;c++) if(!empty(c)) credit[c]+=max<Time>(0,k-1)*grant(c);
+                }
+                turn=(turn+1)%nc;
+                credit[turn] = share=="wrr"? grant(turn) : credit[turn]+grant(turn);
+            }
+        };
+
+        arrive();
+        while(fin<n){
+            int c=pickClass();
+            if(c==-1){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int i=head(c);
+            Time slice=want(c);
+            if(cls[c].disc=='r'){
+                q[c].pop_front();
+                // nobody else can get the CPU before the next event
+                if(ready==1 || (share=="strict" && q[c].empty())) slice=soloRun(cls[c].quantum, ps[i].remaining_time, t+switchCost(ps, i, t, g), nextEvent(ps,nextIdx,io));
+            } else {
+                if(cur[c]<0){ cur[c]=i; if(cls[c].disc=='s') sj[c].drop(i); else q[c].pop_front(); }
+            }
+            if(ready>1 && share!="strict"){
+                if(share=="wrr") slice=min(slice, credit[c]);
+                credit[c]-=slice;
+            }
+            runSlice(ps, i, slice, t, g); cpu[c]+=slice; busy+=slice;
+            bool done=ps[i].remaining_time==0;
+            if(done){ ready--; cur[c]=-1; if(endBurst(ps,i,t,io)) fin++; }
+            arrive();
+            if(!done && cls[c].disc=='r') q[c].push_back(i);
+        }
+        total=t;
+        jobs.assign(nc,0); maxWait.assign(nc,0); wait.assign(nc,0);
+        for(int i=0;i<n;i++){ int c=of[i]; jobs[c]++; wait[c]+=ps[i].waiting_time; maxWait[c]=max(maxWait[c], ps[i].waiting_time); }
+    }
+    void printStats() const override {
+        auto bound=[](int v){ return v==INT_MIN? string("-inf") : v==INT_MAX? string("inf") : to_string(v); };
+        cout<<"Classes ("<<share<<"):\n";
+        for(size_t c=0;c<cls.size();c++){
+            string d= cls[c].disc=='r'? "rr"+to_string(cls[c].quantum) : cls[c].disc=='s'? "sjf" : "fcfs";
+            cout<<"  priority "<<bound(cls[c].lo)<<".."<<bound(cls[c].hi)<<" "<<d<<" weight="<<cls[c].weight
+                <<" jobs="<<jobs[c]<<" share="<<(busy? 100.0*cpu[c]/busy : 0.0)<<"%"
+                <<" avg_wait="<<(jobs[c]? wait[c]/jobs[c] : 0.0)<<" max_wait="<<maxWait[c]<<"\n";
+        }
+    }
+};
+
+// MLFQ (3 queues, RR quanta 2/4/8; demote on full quantum; simple periodic promotion)
+// A job that blocks on I/O before its quantum runs out keeps its level on wakeup.
+class MLFQScheduler: public Scheduler{
+public: string name() const override { return "mlfq"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        const int Q[3]={2,4,8}; const int PROMOTE_PERIOD=12;
+        array<queue<int>,3> q{}; int n=ps.size(), nextIdx=0, fin=0; Time t=0;
+        for(auto& p:ps) p.qlevel=0;
+
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, [&](int i){ q[ps[i].qlevel].push(i); }); };
+        static const char* LEVEL[3]={"mlfq L0", "mlfq L1", "mlfq L2"};
+        auto periodicPromote=[&](){
+            if(t==0 || t%PROMOTE_PERIOD) return;
+            for(int L=2; L>=1; --L){
+                int s=q[L].size();
+                while(s--){ int i=q[L].front(); q[L].pop(); ps[i].qlevel=L-1; q[L-1].push(i); }
+            }
+        };
+
+        arrive();
+        while(fin<n){
+            periodicPromote();
+            if(io.trace) for(int L=0;L<3;L++) io.trace->counter(LEVEL[L], t, q[L].size());
+            int L = !q[0].empty()?0:(!q[1].empty()?1:(!q[2].empty()?2:-1));
+            if(L==-1){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int i=q[L].front(); q[L].pop();
+            // alone at the bottom level nothing changes until the next event or the next
+            // quantum boundary that lands on a promotion
+            Time slice=min<Time>(Q[L], ps[i].remaining_time);
+            if(L==2 && q[2].empty()){
+                Time next=nextEvent(ps,nextIdx,io), from=t+switchCost(ps, i, t, g);
+                for(Time e=from+Q[2]; e<=from+3*Q[2]; e+=Q[2]) if(e%PROMOTE_PERIOD==0){ next=min(next, e-1); break; }
+                slice=soloRun(Q[L], ps[i].remaining_time, from, next);
+            }
+            runSlice(ps, i, slice, t, g);
+            if(ps[i].remaining_time==0 && endBurst(ps,i,t,io)) fin++;
+            arrive();
+            if(ps[i].remaining_time>0){
+                int NL = (slice==Q[L] && L<2)? L+1 : L;
+                ps[i].qlevel=NL; q[NL].push(i);
+            }
+        }
+        total=t;
+    }
+};
+
+// Lottery (quantum 4; tickets ~ 10/priority)
+class LotteryScheduler: public Scheduler{
+    uint32_t seed; double maxErr=0, meanErr=0;
+public:
+    explicit LotteryScheduler(uint32_t seed): seed(seed) {}
+    string name() const override { return "lottery"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps); const int QUANTUM=4;
+        int n=ps.size(), nextIdx=0, fin=0; Time t=0; vector<int> ready;
+        mt19937 gen(seed);
+        ShareTracker share; share.reset(n);
+        auto arrive=[&](){
+            ready.erase(remove_if(ready.begin(),ready.end(),[&](int i){return ps[i].remaining_time==0;}), ready.end());
+            admit(ps, nextIdx, io, t, [&](int i){ ready.push_back(i); share.join(i, tickets(ps[i])); });
+        };
+
+        arrive();
+        while(fin<n){
+            if(ready.empty()){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int chosen=ready.front();
+            if(ready.size()>1){        // a lone job wins without a draw, however long it runs
+                int tot=0; for(int i:ready) tot+=tickets(ps[i]);
+                int pick=uniform_int_distribution<int>(1,tot)(gen), acc=0;
+                for(int i:ready){ acc+=tickets(ps[i]); if(pick<=acc){ chosen=i; break; } }
+            }
+            Time slice=ready.size()==1? soloRun(QUANTUM, ps[chosen].remaining_time, t+switchCost(ps, chosen, t, g), nextEvent(ps,nextIdx,io))
+                                      : min<Time>(QUANTUM, ps[chosen].remaining_time);
+            runSlice(ps, chosen, slice, t, g); share.run(chosen, slice);
+            if(ps[chosen].remaining_time==0){ share.leave(chosen, tickets(ps[chosen])); if(endBurst(ps,chosen,t,io)) fin++; }
+            arrive();
+        }
+        total=t;
+        share.summary(maxErr, meanErr);
+    }
+    void printStats() const override {
+        cout<<"Max Allocation Error: "<<maxErr<<"\n";
+        cout<<"Mean Allocation Error: "<<meanErr<<"\n";
+    }
+};
+
+// Stride (deterministic proportional share; lottery's tickets and quantum). Each job's
+// pass grows by stride = STRIDE1/tickets per unit of CPU and the lowest pass runs next.
+// A job joining or waking starts at the global pass plus whatever it had left over,
+// so it neither starves the others nor gets starved.
+class StrideScheduler: public Scheduler{
+    double maxErr=0, meanErr=0;
+public: string name() const override { return "stride"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps); const int QUANTUM=4; const Time STRIDE1=1<<20;
+        int n=ps.size(), nextIdx=0, fin=0; Time t=0;
+        priority_queue<pair<Time,int>, vector<pair<Time,int>>, greater<pair<Time,int>>> rq;  // (pass, idx)
+        vector<Time> pass(n,0), left(n,0); long long readyTickets=0;
+        VClock gpass; auto global=[&](){ return gpass.at((double)readyTickets/STRIDE1); };   // rebased whenever the tickets change
+        ShareTracker share; share.reset(n);
+        auto join=[&](int i){
+            gpass.rebase(global()); pass[i]=(Time)gpass.base+left[i]; readyTickets+=tickets(ps[i]);
+            share.join(i, tickets(ps[i])); rq.push({pass[i], i});
+        };
+        auto leave=[&](int i){ gpass.rebase(global()); left[i]=pass[i]-(Time)gpass.base; readyTickets-=tickets(ps[i]); share.leave(i, tickets(ps[i])); };
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, join); };
+
+        arrive();
+        while(fin<n){
+            if(rq.empty()){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int i=rq.top().second; rq.pop();
+            Time slice=rq.empty()? soloRun(QUANTUM, ps[i].remaining_time, t+switchCost(ps, i, t, g), nextEvent(ps,nextIdx,io))
+                                 : min<Time>(QUANTUM, ps[i].remaining_time);
+            runSlice(ps, i, slice, t, g);
+            pass[i]+=STRIDE1/tickets(ps[i])*slice; share.run(i, slice); gpass.ran+=slice;
+            if(ps[i].remaining_time==0){ leave(i); if(endBurst(ps,i,t,io)) fin++; }
+            arrive();
+            if(ps[i].remaining_time>0) rq.push({pass[i], i});
+        }
+        total=t;
+        share.summary(maxErr, meanErr);
+    }
+    void printStats() const override {
+        cout<<"Max Allocation Error: "<<maxErr<<"\n";
+        cout<<"Mean Allocation Error: "<<meanErr<<"\n";
+    }
+};
+
+
+// CFS-lite (min vruntime; slice ∝ 1/priority)
+class CFSScheduler: public Scheduler{
+    string governor;
+public:
+    explicit CFSScheduler(string gov=""): governor(move(gov)) {}
+    string name() const override { return "cfs"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps); const int BASE_SLICE=4; const double UTIL_HALFLIFE=8;
+        int n=ps.size(), nextIdx=0, fin=0; Time t=0;
+        // governor "steady" (schedutil-like): util tracks the work done per unit of time,
+        // decaying with a half-life of UTIL_HALFLIFE, and the CPU runs at the slowest
+        // P-state with 25% headroom over it. "race" (the default) stays at full speed and
+        // idles once the work is done.
+        bool steady= governor=="steady"; double util=0;
+        auto demand=[&](Time from, Time work){
+            if(!steady || t<=from) return;
+            double a=pow(0.5, (t-from)/UTIL_HALFLIFE);
+            util=util*a + (double)work/(t-from)*(1-a);
+            setLevel(power.atLeast(min(1.0, 1.25*util)), t);
+        };
+        level=-1; if(steady) setLevel(0, 0);
+        ReadySet<double> rs; rs.reset(n);                  // key: vruntime, ties to earliest arrival
+        vector<VClock> vc(n);
+        auto w=[&](int i){ return 1.0 / max(1, ps[i].priority); };
+        auto arrive=[&](){
+            admit(ps, nextIdx, io, t, [&](int i){
+                // a task waking from I/O does not get to bank the vruntime it missed while blocked
+                if(ps[i].bidx>0 && rs.size()) vc[i].rebase(max(ps[i].vruntime, rs.at(rs.argmin())));
+                rs.put(i, ps[i].vruntime=vc[i].at(w(i)));
+            });
+        };
+        for(auto& p: ps) p.vruntime=0.0;
+
+        arrive();
+        while(fin<n){
+            Time from=t;
+            if(!rs.size()){ idleUntil(t, nextEvent(ps,nextIdx,io), g); demand(from, 0); arrive(); continue; }
+            int i=rs.argmin();
+            Time unit = max<Time>(1, min((Time)ceil(BASE_SLICE*w(i)), wallFor(ps[i]))), slice=unit, left=ps[i].remaining_time;
+            // Under steady a lone job climbs a P-state every few slices, as 1.25x its own rate is
+            // always faster, until it reaches full speed. From there, with no switch to pay,
+            // util only rises and the level stays put, and one decay over the whole run equals
+            // the per-slice ones: a solo run again.
+            Time sw=switchCost(ps, i, t, g);
+            if(rs.size()==1 && (!steady || (lvl()==power.top() && sw==0)))
+                slice=soloRun(unit, wallFor(ps[i]), t+sw, nextEvent(ps,nextIdx,io));
+            runSlice(ps, i, slice, t, g); vc[i].ran+=slice; ps[i].vruntime=vc[i].at(w(i));
+            demand(from, left-ps[i].remaining_time);
+            if(ps[i].remaining_time==0){ rs.drop(i); if(endBurst(ps,i,t,io)) fin++; }
+            else rs.put(i, ps[i].vruntime);
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// Runqueue for EEVDF: a treap keyed by (eligible time ve, idx) in which every node also
+// knows the earliest virtual deadline in its subtree, so "earliest deadline among tasks
+// with ve <= V" is a single root-to-leaf walk.
+class EligibleTree{
+    struct Node{ int l=-1, r=-1; uint32_t pri=0; double ve=0, vd=0; int best=-1; };
+    vector<Node> t; int root=-1; mt19937 rng{375};
+    bool earlier(int a, int b) const { return t[a].vd<t[b].vd || (t[a].vd==t[b].vd && a<b); }
+    bool less(int a, int b) const { return t[a].ve<t[b].ve || (t[a].ve==t[b].ve && a<b); }
+    void pull(int x){
+        int b=x;
+        if(t[x].l>=0 && earlier(t[t[x].l].best, b)) b=t[t[x].l].best;
+        if(t[x].r>=0 && earlier(t[t[x].r].best, b)) b=t[t[x].r].best;
+        t[x].best=b;
+    }
+    // a gets the nodes ordered before k, b the rest.
+    void split(int x, int k, int& a, int& b){
+        if(x<0){ a=b=-1; return; }
+        if(less(x,k)){ split(t[x].r, k, t[x].r, b); a=x; }
+        else         { split(t[x].l, k, a, t[x].l); b=x; }
+        pull(x);
+    }
+    int eraseMin(int x){
+        if(t[x].l<0) return t[x].r;
+        t[x].l=eraseMin(t[x].l); pull(x); return x;
+    }
+    int merge(int a, int b){
+        if(a<0) return b;
+        if(b<0) return a;
+        if(t[a].pri>t[b].pri){ t[a].r=merge(t[a].r, b); pull(a); return a; }
+        t[b].l=merge(a, t[b].l); pull(b); return b;
+    }
+public:
+    void reset(int n){ t.assign(n, Node{}); root=-1; }
+    bool empty() const { return root<0; }
+    void insert(int i, double ve, double vd){
+        t[i]=Node{}; t[i].pri=rng(); t[i].ve=ve; t[i].vd=vd; t[i].best=i;
+        int a,b; split(root, i, a, b); root=merge(merge(a, i), b);
+    }
+    void erase(int i){
+        int a,b; split(root, i, a, b);                   // i is now the leftmost node of b
+        root=merge(a, eraseMin(b));
+    }
+    int pick(double V) const {
+        int best=-1;
+        for(int x=root; x>=0; ){
+            if(t[x].ve<=V){
+                if(best<0 || earlier(x,best)) best=x;
+                if(t[x].l>=0 && earlier(t[t[x].l].best, best)) best=t[t[x].l].best;
+                x=t[x].r;
+            } else x=t[x].l;
+        }
+        // the smallest ve is never above V; if rounding says otherwise, take it anyway
+        if(best<0 && root>=0){ best=root; while(t[best].l>=0) best=t[best].l; }
+        return best;
+    }
+};
+
+// EEVDF (eligible virtual deadline first; weight 1/priority as in CFS-lite). V is the
+// weight-averaged eligible time of the ready tasks, so a task is eligible while its lag
+// w*(V-ve) is non-negative. The eligible task with the earliest virtual deadline
+// ve + REQUEST/w runs for one request. Lag survives blocking on I/O and is restored,
+// scaled for the new load, when the task rejoins.
+class EEVDFScheduler: public Scheduler{
+public: string name() const override { return "eevdf"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps); const int REQUEST=4;
+        int n=ps.size(), nextIdx=0, fin=0; Time t=0;
+        EligibleTree rq; rq.reset(n);
+        // ve = base + ran/w per task, so sum(w*ve) over the ready tasks = A + E with A the
+        // sum of w*base and E the CPU they have had since joining
+        vector<VClock> ve(n); vector<double> lag(n,0); double A=0, W=0, V=0; Time E=0;
+        auto wt=[&](int i){ return 1.0 / max(1, ps[i].priority); };
+        auto join=[&](int i){
+            double w=wt(i);
+            ve[i].rebase(W>0? V - lag[i]*(W+w)/(W*w) : V);
+            A+=w*ve[i].base; W+=w; V=(A+E)/W;
+            rq.insert(i, ve[i].base, ve[i].base+REQUEST/w);
+        };
+        auto leave=[&](int i){
+            double w=wt(i), v=ve[i].at(w);
+            lag[i]=clamp(w*(V-v), -(double)REQUEST, (double)REQUEST);
+            A-=w*ve[i].base; E-=ve[i].ran; W-=w;
+            if(W>1e-9) V=(A+E)/W; else A=W=0;
+        };
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, join); };
+
+        arrive();
+        while(fin<n){
+            if(rq.empty()){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int i=rq.pick(V);
+            rq.erase(i);
+            Time slice=rq.empty()? soloRun(REQUEST, ps[i].remaining_time, t+switchCost(ps, i, t, g), nextEvent(ps,nextIdx,io))
+                                 : min<Time>(REQUEST, ps[i].remaining_time);
+            runSlice(ps, i, slice, t, g);
+            ve[i].ran+=slice; E+=slice; V=(A+E)/W;
+            if(ps[i].remaining_time==0){ leave(i); if(endBurst(ps,i,t,io)) fin++; }
+            else { double v=ve[i].at(wt(i)); rq.insert(i, v, v+REQUEST/wt(i)); }
+            arrive();
+        }
+        total=t;
+    }
+};
+
+// Hierarchical fair share (cgroup-style). Groups form a tree from the "a/b" paths in
+// the workload's group column, weighted by its "group PATH WEIGHT" lines (default 1).
+// Every group orders its runnable children, tasks (weight 1/priority) and subgroups,
+// by vruntime. A pick walks down from the root, taking the smallest vruntime at each
+// level, so fairness holds between groups first and between tasks inside a group
+// second. Running charges the task and each ancestor slice/weight. An entity that
+// becomes runnable starts no earlier than the smallest vruntime already queued.
+class GroupScheduler: public Scheduler{
+    map<string,double> weights;
+    vector<string> gname; vector<double> gweight; vector<Time> gcpu; vector<int> gtasks;
+    vector<double> gwait, gturn; Time busy=0;
+public:
+    explicit GroupScheduler(map<string,double> w): weights(move(w)) {}
+    string name() const override { return "group"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps); const int BASE_SLICE=4;
+        int n=ps.size(), nextIdx=0, fin=0; Time t=0;
+        // entities: tasks 0..n-1, then groups; entity n is the root group
+        vector<int> parent(n,-1); vector<double> vr(n,0.0), w(n);
+        map<string,int> gid;
+        gname.assign(1,"/"); gweight.assign(1,1.0); parent.push_back(-1); vr.push_back(0); w.push_back(1.0); gid[""]=n;
+        auto groupOf=[&](const string& path){
+            string cur; int at=n;
+            for(size_t i=0; i<=path.size(); i++){
+                if(i<path.size() && path[i]!='/'){ cur+=path[i]; continue; }
+                if(cur.empty() || cur.back()=='/') continue;
+                auto it=gid.find(cur);
+                if(it==gid.end()){
+                    int e=parent.size(); it=gid.emplace(cur,e).first;
+                    double wt = weights.count(cur)? weights[cur] : 1.0;
+                    parent.push_back(at); vr.push_back(0); w.push_back(wt); gname.push_back("/"+cur); gweight.push_back(wt);
+                }
+                at=it->second; cur+='/';
+            }
+            return at;
+        };
+        for(int i=0;i<n;i++){ parent[i]=groupOf(ps[i].group); w[i]=1.0/max(1,ps[i].priority); }
+        int ne=parent.size();
+        vector<set<pair<double,int>>> rq(ne); vector<VClock> vc(ne);   // vr[e] = vc[e].at(w[e]), the key in rq
+        gcpu.assign(ne-n,0); gtasks.assign(ne-n,0); gwait.assign(ne-n,0); gturn.assign(ne-n,0); busy=0;
+
+        function<void(int)> enqueue=[&](int e){
+            int p=parent[e]; bool wasIdle=rq[p].empty();
+            if(!wasIdle){ vc[e].rebase(max(vr[e], rq[p].begin()->first)); vr[e]=vc[e].base; }
+            rq[p].insert({vr[e],e});
+            if(wasIdle && parent[p]>=0) enqueue(p);
+        };
+        function<void(int)> dequeue=[&](int e){
+            int p=parent[e]; rq[p].erase({vr[e],e});
+            if(rq[p].empty() && parent[p]>=0) dequeue(p);
+        };
+        auto pick=[&](){ int e=n; while(e>=n) e=rq[e].begin()->second; return e; };
+        auto charge=[&](int i, Time d){
+            for(int e=i; parent[e]>=0; e=parent[e]){
+                int p=parent[e]; rq[p].erase({vr[e],e}); vc[e].ran+=d; vr[e]=vc[e].at(w[e]); rq[p].insert({vr[e],e});
+                gcpu[p-n]+=d;
+            }
+        };
+        auto arrive=[&](){ admit(ps, nextIdx, io, t, enqueue); };
+
+        arrive();
+        while(fin<n){
+            if(rq[n].empty()){ idleUntil(t, nextEvent(ps,nextIdx,io), g); arrive(); continue; }
+            int i=pick();
+            Time unit = max<Time>(1, min((Time)ceil(BASE_SLICE*w[i]), ps[i].remaining_time)), slice=unit;
+            bool alone=true; for(int e=parent[i]; e>=0; e=parent[e]) alone &= rq[e].size()==1;
+            if(alone) slice=soloRun(unit, ps[i].remaining_time, t+switchCost(ps, i, t, g), nextEvent(ps,nextIdx,io));
+            runSlice(ps, i, slice, t, g); busy+=slice;
+            charge(i, slice);
+            if(ps[i].remaining_time==0){ dequeue(i); if(endBurst(ps,i,t,io)) fin++; }
+            arrive();
+        }
+        total=t;
+        for(int i=0;i<n;i++) for(int e=parent[i]; e>=0; e=parent[e]){
+            gtasks[e-n]++; gwait[e-n]+=ps[i].waiting_time; gturn[e-n]+=ps[i].turnaround_time;
+        }
+    }
+    void printStats() const override {
+        cout<<"Group Shares:\n";
+        for(size_t k=0;k<gname.size();k++){
+            int c=gtasks[k];
+            cout<<"  "<<gname[k]<<" weight="<<gweight[k]<<" cpu="<<gcpu[k]
+                <<" share="<<(busy? 100.0*gcpu[k]/busy : 0.0)<<"% tasks="<<c
+                <<" avg_wait="<<(c? gwait[k]/c : 0.0)<<" avg_turnaround="<<(c? gturn[k]/c : 0.0)<<"\n";
+        }
+    }
+};
+
+// Processor-demand bookkeeping for EDF admission. Admitted jobs sit at fixed slots in
+// (deadline, idx) order. Each slot holds the job's remaining CPU and
+// val = deadline - (remaining CPU of it and every earlier-deadline job), so its slack
+// at time t is val - t. Running a job for d raises val by d from its slot on; admitting
+// one of c lowers it by c past its slot. A segment tree with lazy adds answers prefix
+// demand and suffix min slack in O(log n). The DVFS governor keeps one per P-state
+// with fractional values (V=double).
+template<class V> class DemandTree{
+    static constexpr V NONE=TIME_MAX/4;        // empty slot; stays huge under any adds
+    int n=1; vector<V> sum, mn, lz;
+    void apply(int x, V v){ mn[x]+=v; lz[x]+=v; }
+    void push(int x){ if(lz[x]){ apply(2*x,lz[x]); apply(2*x+1,lz[x]); lz[x]=0; } }
+    void pull(int x){ sum[x]=sum[2*x]+sum[2*x+1]; mn[x]=min(mn[2*x],mn[2*x+1]); }
+    // slot p: add rem to its demand (delta), or set both demand and val
+    void point(int x, int l, int r, int p, V rem, V val, bool delta){
+        if(l==r){ if(delta) sum[x]+=rem; else { sum[x]=rem; mn[x]=val; } return; }
+        push(x); int m=(l+r)/2;
+        if(p<=m) point(2*x,l,m,p,rem,val,delta); else point(2*x+1,m+1,r,p,rem,val,delta);
+        pull(x);
+    }
+    void add(int x, int l, int r, int a, V v){         // val += v on slots >= a
+        if(r<a) return;
+        if(a<=l){ apply(x,v); return; }
+        push(x); int m=(l+r)/2;
+        add(2*x,l,m,a,v); add(2*x+1,m+1,r,a,v); pull(x);
+    }
+    V demand(int x, int l, int r, int b){             // remaining CPU in slots <= b
+        if(b<l) return 0;
+        if(r<=b) return sum[x];
+        push(x); int m=(l+r)/2;
+        return demand(2*x,l,m,b)+demand(2*x+1,m+1,r,b);
+    }
+    V minVal(int x, int l, int r, int a){              // min val over slots >= a
+        if(r<a) return NONE;
+        if(a<=l) return mn[x];
+        push(x); int m=(l+r)/2;
+        return min(minVal(2*x,l,m,a), minVal(2*x+1,m+1,r,a));
+    }
+public:
+    void reset(int slots){ n=max(1,slots); sum.assign(4*n,0); mn.assign(4*n,NONE); lz.assign(4*n,0); }
+    // Admit c units due at d into slot p if neither it nor any admitted job would then
+    // miss its deadline, given the CPU works only on admitted jobs from t on.
+    bool admit(int p, V d, V c, V t){
+        V before=demand(1,0,n-1,p-1);
+        if(d-t-before-c<0 || minVal(1,0,n-1,p+1)-t<c) return false;
+        place(p, d, c);
+        return true;
+    }
+    // Slot p takes c units due at d without a check.
+    void place(int p, V d, V c){
+        point(1,0,n-1,p,c,d-demand(1,0,n-1,p-1)-c,false);
+        add(1,0,n-1,p+1,-c);
+    }
+    void ran(int p, V d){ point(1,0,n-1,p,-d,0,true); add(1,0,n-1,p,d); }
+    // Slot p leaves; whatever it still owed stops counting against later slots.
+    void done(int p){
+        V left=owes(p); point(1,0,n-1,p,0,NONE,false);
+        if(left) add(1,0,n-1,p+1,left);
+    }
+    // Slot p's deadline has passed: its demand still delays later slots, its own
+    // slack no longer counts.
+    void retire(int p){ point(1,0,n-1,p,owes(p),NONE,false); }
+    V owes(int p){ return demand(1,0,n-1,p)-demand(1,0,n-1,p-1); }
+    V slack() const { return mn[1]; }            // min val over all slots
+};
+
+// EDF (preemptive). If no deadline present, use arrival + 2*burst. With admission
+// control a new job is accepted only if the demand check says every admitted job can
+// still meet its deadline; otherwise it is dropped (reject) or only runs when no
+// admitted job is ready (defer). Misses avoided are counted against plain EDF.
+class EDFScheduler: public Scheduler{
+    string admission, governor; size_t admitted=0, refused=0, misses=0, lateRefused=0, plainMisses=0;
+public:
+    explicit EDFScheduler(string adm="", string gov=""): admission(move(adm)), governor(move(gov)) {}
+    string name() const override { return "edf"; }
+    void schedule(vector<Process>& ps, Gantt& g, Time& total) override {
+        sortByArrival(ps); ensureRemaining(ps); io.reset(ps);
+        for(auto& p: ps) if(p.deadline==0) p.deadline = p.arrival_time + 2*p.burst_time;
+        if(!admission.empty()){
+            EDFScheduler plain("", governor); plain.cost=cost; plain.power=power;
+            vector<Process> copy=ps; Gantt pg; Time pt=0;
+            plain.schedule(copy, pg, pt); plainMisses=plain.misses;
+        }
+
+        int n=ps.size(), nextIdx=0, finished=0; Time t=0; int run=-1; Time runlen=0;   // run: job on the CPU, -1 = idle
+        ReadySet<Time> rs; rs.reset(n, true);              // key: deadline, then remaining
+        ReadySet<Time> bg; bg.reset(admission=="defer"? n : 0, true);   // deferred jobs
+        auto flush=[&](){ if(runlen>0){ record(g, run, run<0? "IDLE" : ps[run].id, t-runlen, runlen); runlen=0; } };
+        // admission state: slot of each job in deadline order, CPU still owed, verdict
+        DemandTree<Time> dt; vector<int> slot(n); vector<char> ok(n,1);
+        // governor "deadline": run at the slowest P-state at which every admitted job still
+        // gets the CPU it owes (this burst and later ones) done by its deadline, in
+        // deadline order. speed[l] holds the demand check at P-state l, scaled by f:
+        // val = f*d - (CPU owed up to that slot) - f per job, the f being one time unit
+        // each job may lose to whole-unit slices. A job past its deadline is retired:
+        // hurrying no longer saves it.
+        bool dvfs= governor=="deadline"; level=-1;
+        vector<DemandTree<double>> speed(dvfs? power.freq.size() : 0); vector<char> placed(n,0);
+        priority_queue<pair<Time,int>, vector<pair<Time,int>>, greater<pair<Time,int>>> due;
+        if(!admission.empty() || dvfs){
+            vector<int> ord(n); iota(ord.begin(), ord.end(), 0);
+            sort(ord.begin(), ord.end(), [&](int a, int b){ return make_pair(ps[a].deadline,a)<make_pair(ps[b].deadline,b); });
+            for(int k=0;k<n;k++) slot[ord[k]]=k;
+            if(!admission.empty()) dt.reset(n);
+            for(auto& s: speed) s.reset(n);
+        }
+        admitted=refused=misses=lateRefused=0;
+        auto enqueue=[&](int i){
+            if(!admission.empty() && ps[i].bidx==0){
+                Time cpu=0; for(size_t b=0;b<ps[i].bursts.size();b+=2) cpu+=ps[i].bursts[b];
+                ok[i]=dt.admit(slot[i], ps[i].deadline, cpu, t);
+                if(ok[i]) admitted++;
+                else { refused++; if(admission=="reject"){ ps[i].remaining_time=0; finished++; io.count(t, -1); return; } }
+            }
+            (ok[i]? rs : bg).put(i, ps[i].deadline, ps[i].remaining_time);
+            if(dvfs && ok[i] && ps[i].bidx==0){
+                Time cpu=0; for(size_t b=0;b<ps[i].bursts.size();b+=2) cpu+=ps[i].bursts[b];
+                for(size_t l=0;l<speed.size();l++) speed[l].place(slot[i], power.freq[l]*ps[i].deadline, cpu+power.freq[l]);
+                placed[i]=1; due.push({ps[i].deadline, i});
+            }
+        };
+        // P-state for job i's next step: of those that pass the check, the cheapest per
+        // unit of work the step completes, and a slower one only if that is below the
+        // full-speed price. Time is whole units, so a slow step cut short by an arrival,
+        // or the rounded-up end of a burst, can finish less work than its energy would
+        // buy at full speed; such a step runs at full speed instead.
+        auto govern=[&](int i){
+            while(!due.empty() && due.top().first<=t){
+                int j=due.top().second; due.pop();
+                if(placed[j]) for(auto& s: speed) s.retire(slot[j]);
+            }
+            int lo=0; while(lo<power.top() && speed[lo].slack()<power.freq[lo]*t-1e-9) lo++;
+            Process& p=ps[i]; Time room=nextEvent(ps,nextIdx,io)-t;
+            int l=power.top(); double best=power.watts[l];
+            for(int k=lo;k<power.top();k++){
+                double f=power.freq[k];
+                Time wall=max<Time>(1, (Time)ceil((p.remaining_time-p.carry)/f-1e-9)), len=min(wall, room);
+                Time work= len==wall? p.remaining_time : min(p.remaining_time, (Time)floor(len*f+p.carry+1e-9));
+                if(len>0 && work>0 && len*power.watts[k]/work<best-1e-12){ best=len*power.watts[k]/work; l=k; }
+            }
+            return l;
+        };
+
+        while(finished<n){
+            admit(ps, nextIdx, io, t, enqueue);
+            if(finished==n) break;
+            int idx = rs.argmin();
+            if(idx==-1) idx=bg.argmin();
+            if(idx==-1){
+                Time nx=nextEvent(ps,nextIdx,io);
+                if(nx==TIME_MAX) break;
+                if(run>=0){ flush(); run=-1; }
+                runlen += max<Time>(0, nx-t); t=nx; continue;
+            }
+            ReadySet<Time>& q = ok[idx]? rs : bg;
+            if(run!=idx){ flush(); run=idx; charge(ps, idx, t, g); }
+            if(dvfs){
+                int l=govern(idx);
+                if(l!=lvl()){ flush(); setLevel(l, t); }    // each slice is priced at one P-state
+            }
+            // nothing can preempt before the next arrival or wakeup, so run straight to it
+            // (an arrival during the switch itself gets a say first)
+            Time step=max<Time>(0, min(wallFor(ps[idx]), nextEvent(ps,nextIdx,io)-t));
+            Time done=workIn(ps[idx], step);
+            ps[idx].remaining_time-=done; runlen+=step; t+=step; if(step) ps[idx].last_ran=t;
+            if(!admission.empty() && ok[idx]) dt.ran(slot[idx], done);
+            if(placed[idx]) for(auto& s: speed) s.ran(slot[idx], done);
+            if(ps[idx].remaining_time==0){
+                q.drop(idx); flush();
+                if(endBurst(ps,idx,t,io)){
+                    finished++;
+                    if(t>ps[idx].deadline){ misses++; if(!ok[idx]) lateRefused++; }
+                    if(!admission.empty() && ok[idx]) dt.done(slot[idx]);
+                    if(placed[idx]){ for(auto& s: speed) s.done(slot[idx]); placed[idx]=0; }
+                }
+                run=-1;
+            } else q.put(idx, ps[idx].deadline, ps[idx].remaining_time);
+        }
+        total=t;
+        if(admission=="reject"){    // dropped jobs never ran; report on the admitted ones
+            vector<Process> kept; kept.reserve(admitted);
+            for(int i=0;i<n;i++) if(ok[i]) kept.push_back(move(ps[i]));
+            ps.swap(kept);
+        }
+    }
+    void printStats() const override {
+        if(admission.empty()){ cout<<"Deadline Misses: "<<misses<<"\n"; return; }
+        cout<<"Admission ("<<admission<<"): "<<admitted<<" admitted, "<<refused<<(admission=="reject"? " rejected" : " deferred")<<"\n";
+        cout<<"Deadline Misses: "<<misses-lateRefused<<" admitted";
+        if(admission=="defer") cout<<", "<<lateRefused<<" deferred";
+        cout<<" (plain EDF: "<<plainMisses<<", avoided "<<(long long)plainMisses-(long long)misses<<")\n";
+    }
+};
+
+// -------------- Input --------------
+// Burst column: either a single CPU burst ("8") or alternating CPU and I/O bursts
+// ("4,3,5"), starting and ending with CPU. An I/O burst may name its device as
+// "dev:len" ("4,1:3,5"); otherwise it goes to device 0.
+inline bool parseBursts(const string& spec, Process& p){
+    p.bursts.clear(); p.devs.clear(); p.burst_time=0;
+    istringstream ss(spec); string tok;
+    while(getline(ss,tok,',')){
+        bool cpu = p.bursts.size()%2==0; int dev=0; Time len=0;
+        size_t c=tok.find(':');
+        try{
+            if(c!=string::npos){ if(cpu) return false; dev=stoi(tok.substr(0,c)); len=stoll(tok.substr(c+1)); }
+            else len=stoll(tok);
+        }catch(...){ return false; }
+        if(len<=0 || dev<0) return false;
+        p.bursts.push_back(len);
+        if(cpu) p.burst_time+=len; else p.devs.push_back(dev);
+    }
+    return p.bursts.size()%2==1;
+}
+// Drops blank lines and comments; false when nothing is left to parse.
+inline bool workloadLine(string& line){
+    // strip leading spaces
+    size_t i=line.find_first_not_of(" \t\r\n");
+    if(i==string::npos) return false;
+    if(line[i]=='#') return false;
+    // remove inline comment
+    size_t hash=line.find('#'); if(hash!=string::npos) line=line.substr(0,hash);
+    return true;
+}
+inline vector<Process> parseProcesses(istream& in){
+    vector<Process> ps; string line;
+    while(getline(in,line)){
+        if(!workloadLine(line)) continue;
+        istringstream iss(line);
+        Process p{}; string burst;
+        if(!(iss>>p.id) || p.id=="periodic" || p.id=="group") continue;
+        if(!(iss>>p.arrival_time>>burst>>p.priority)) continue;
+        if(!parseBursts(burst,p)){ cerr<<"Bad burst spec for "<<p.id<<": "<<burst<<"\n"; continue; }
+        // optional trailing columns: deadline (all digits) and/or group path
+        bool bad=false;
+        for(string tok; !bad && iss>>tok; ){
+            if(tok.find_first_not_of("0123456789")!=string::npos){ p.group=tok; continue; }
+            auto r=from_chars(tok.data(), tok.data()+tok.size(), p.deadline);
+            if(r.ec!=errc()){ cerr<<"Bad deadline for "<<p.id<<": "<<tok<<"\n"; bad=true; }
+        }
+        if(!bad) ps.push_back(p);
+    }
+    return ps;
+}
+inline vector<Process> loadProcesses(const string& filename){
+    if(filename.empty()) return {};
+    ifstream in(filename);
+    if(!in){ cerr<<"Error opening file: "<<filename<<"\n"; return {}; }
+    return parseProcesses(in);
+}
+// Group weight lines: "group PATH WEIGHT", e.g. "group tenantA/batch 2".
+inline map<string,double> parseGroupWeights(istream& in){
+    map<string,double> ws; string line, kw, path; double w;
+    while(getline(in,line)){
+        if(!workloadLine(line)) continue;
+        istringstream iss(line);
+        if(!(iss>>kw) || kw!="group") continue;
+        if(!(iss>>path>>w) || w<=0){ cerr<<"Bad group line: "<<line<<"\n"; continue; }
+        while(!path.empty() && path.back()=='/') path.pop_back();
+        while(!path.empty() && path[0]=='/') path.erase(0,1);
+        ws[path]=w;
+    }
+    return ws;
+}
+inline map<string,double> loadGroupWeights(const string& filename){
+    ifstream in(filename);
+    return in? parseGroupWeights(in) : map<string,double>{};
+}
+inline vector<Process> defaultProcesses(){
+    return { {"P1",0,8,2}, {"P2",1,4,1}, {"P3",2,9,3}, {"P4",3,5,4} };
+}
+// Scheduler knobs. The group weights come from the workload file, so each file fills
+// in its own copy. The seed drives lottery draws; it is time-based unless --seed is given.
+struct SchedConfig{
+    int quantum=4; map<string,double> groupWeights; CostModel cost;
+    vector<MLQClass> mlqClasses; string mlqShare="strict";   // empty = the classic two classes
+    string admission;                                        // EDF: "", "reject" or "defer"
+    PowerModel power; string governor;                       // DVFS: "" (full speed), race, steady (CFS), deadline (EDF)
+    uint32_t seed=(uint32_t)chrono::high_resolution_clock::now().time_since_epoch().count();
+};
+
+inline unique_ptr<Scheduler> makeScheduler(const string& type, const SchedConfig& cfg){
+    unique_ptr<Scheduler> s;
+    if      (type=="fcfs")    s=make_unique<FCFSScheduler>();
+    else if (type=="sjf")     s=make_unique<SJFScheduler>();
+    else if (type=="srtf")    s=make_unique<SRTFScheduler>();
+    else if (type=="priority")s=make_unique<PriorityNPScheduler>();
+    else if (type=="rr")      s=make_unique<RRScheduler>(cfg.quantum);
+    else if (type=="mlq")     s=make_unique<MLQScheduler>(cfg.mlqClasses, cfg.mlqShare, cfg.quantum);
+    else if (type=="mlfq")    s=make_unique<MLFQScheduler>();
+    else if (type=="lottery") s=make_unique<LotteryScheduler>(cfg.seed);
+    else if (type=="stride")  s=make_unique<StrideScheduler>();
+    else if (type=="cfs")     s=make_unique<CFSScheduler>(cfg.governor);
+    else if (type=="eevdf")   s=make_unique<EEVDFScheduler>();
+    else if (type=="group")   s=make_unique<GroupScheduler>(cfg.groupWeights);
+    else if (type=="edf")     s=make_unique<EDFScheduler>(cfg.admission, cfg.governor);
+    if(s){ s->cost=cfg.cost; s->power=cfg.power; }
+    return s;
+}
+
+// Entry point of the single-policy programs: `prog [WORKLOAD]`, defaulting to the
+// four-process example.
+inline int runStandalone(const string& type, int argc, char** argv){
+    string input = argc>1? argv[1] : "";
+    vector<Process> ps = input.empty()? defaultProcesses() : loadProcesses(input);
+    if(ps.empty()){ cerr<<"No processes loaded.\n"; return 1; }
+    SchedConfig cfg; if(!input.empty()) cfg.groupWeights=loadGroupWeights(input);
+    unique_ptr<Scheduler> sch=makeScheduler(type, cfg);
+    Gantt g; Time total=0;
+    sch->schedule(ps, g, total);
+    printResults(ps, total, g, sch->io);
+    sch->printStats();
+    return 0;
+}
@@ -1,418 +1,1206 @@
 // simulator.cpp 
-// Modular Task Scheduling Simulator: fcfs, sjf, srtf, priority, rr, mlq, mlfq, lottery, cfs, edf
-#include <bits/stdc++.h>
-using namespace std;
-
-struct Process {
-    string id; int arrival_time; int burst_time; int priority;
-    int remaining_time=0; int waiting_time=0; int turnaround_time=0;
-    int deadline=0;                // for EDF
-    double vruntime=0.0;           // for CFS
-    int qlevel=0;                  // for MLFQ
-};
+// Modular Task Scheduling Simulator: fcfs, sjf, srtf, priority, rr, mlq, mlfq, lottery, stride, cfs, eevdf, group, edf
+#include "sched_core.h"
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 
-using Gantt = vector<pair<string,int>>;
+// -------------- Periodic real-time tasks --------------
+// A periodic task releases a job of wcet every period from phase on, each due deadline
+// after its release. Jobs are released lazily as simulated time reaches them, so only
+// the backlog is ever held in memory. With stopAtRepeat the backlog is compared at
+// hyperperiod boundaries; once two boundaries match the schedule is periodic from there
+// on, so whole hyperperiods up to the horizon are skipped and their stats scaled in.
+// Switching between tasks costs as in the cost model, the cache reload going by the
+// task's last run; a switch runs to its end before releases during it are looked at.
+struct PeriodicTask{ string id; Time phase=0, wcet=0, period=0, deadline=0; };
 
-static void printGantt(const Gantt& g){
-    cout << "Gantt: ";
-    for (auto& e: g) cout << e.first << "(" << e.second << ") ";
-    cout << "\n";
-}
-static void calcMetrics(vector<Process>& ps, int total_time,
-                        double& avg_wait, double& avg_turn, double& cpu, double& thr){
-    double aw=0, at=0; int busy=0;
-    for (auto& p: ps){ aw += p.waiting_time; at += p.turnaround_time; busy += p.burst_time; }
-    int n = (int)ps.size();
-    avg_wait = n? aw/n : 0; avg_turn = n? at/n : 0;
-    cpu = total_time? (100.0*busy/total_time) : 0.0;
-    thr = total_time? (double)n/total_time : 0.0;
-}
-static void printResults(vector<Process>& ps, int total_time, const Gantt& g){
-    double aw,at,cpu,thr; calcMetrics(ps,total_time,aw,at,cpu,thr);
-    printGantt(g);
-    cout<<fixed<<setprecision(2);
-    cout<<"Average Waiting Time: "<<aw<<"\n";
-    cout<<"Average Turnaround Time: "<<at<<"\n";
-    cout<<"CPU Utilization: "<<cpu<<"%\n";
-    cout<<"Throughput: "<<thr<<" processes/unit time\n";
-}
+class PeriodicSim{
+public:
+    enum Policy{ EDF, RM };
+private:
+    struct Job{ Time release, remaining, deadline; };
+    struct Stats{ long long released=0, done=0, missed=0; __int128 resp=0; Time maxResp=0; };
+    Policy pol; vector<PeriodicTask> ts; vector<deque<Job>> q; vector<Stats> st;
+    Time horizon=0, hyper=0, busy=0, skippedAt=-1, skipped=0, cs=0, switches=0;
+    int cur=-1; Time pending=0; vector<Time> lastRan;  // task holding the CPU, switch time left, end of each task's last run
 
-class Scheduler{
+    static Time lcmCapped(Time a, Time b, Time cap){
+        Time g=__gcd(a,b), m=a/g;
+        return (m > cap/b)? -1 : m*b;
+    }
+    Time key(int i) const { return pol==EDF? q[i].front().deadline : ts[i].period; }
+    // Backlog relative to t: what must match at two boundaries for the schedule to repeat.
+    vector<Time> state(Time t, const vector<Time>& nextRel) const {
+        vector<Time> s;
+        for(size_t i=0;i<ts.size();i++){
+            s.push_back(nextRel[i]-t); s.push_back(q[i].size());
+            for(auto& j: q[i]){ s.push_back(j.remaining); s.push_back(j.deadline-t); s.push_back(j.release-t); }
+            if(cost.on()) s.push_back(lastRan[i]<0? -1 : min(t-lastRan[i], cost.decay));
+        }
+        if(cost.on()){ s.push_back(cur); s.push_back(pending); }
+        return s;
+    }
 public:
-    virtual ~Scheduler()=default;
-    virtual string name() const = 0;
-    virtual void schedule(vector<Process>& ps, Gantt& g, int& total_time)=0;
+    CostModel cost;
+    explicit PeriodicSim(Policy p): pol(p) {}
+
+    // False when no horizon is given and the hyperperiod is too large to default to.
+    bool run(const vector<PeriodicTask>& tasks, Time hor, bool stopAtRepeat, Gantt& g){
+        ts=tasks; int n=ts.size(); q.assign(n,{}); st.assign(n,{}); busy=0; skippedAt=-1; skipped=0; cs=0; switches=0;
+        cur=-1; pending=0; lastRan.assign(n,-1);
+        Time maxPhase=0; hyper=1;
+        for(auto& k: ts){ maxPhase=max(maxPhase,k.phase); if(hyper>0) hyper=lcmCapped(hyper,k.period,TIME_MAX/4); }
+        if(hor<=0 && hyper<0){ cerr<<"Hyperperiod of these periods overflows; give --horizon\n"; return false; }
+        horizon = hor>0? hor : maxPhase + hyper;
+        if(!stopAtRepeat || hyper<=0) hyper=0;
+
+        vector<Time> nextRel(n);
+        priority_queue<pair<Time,int>, vector<pair<Time,int>>, greater<pair<Time,int>>> rel;
+        for(int i=0;i<n;i++){ nextRel[i]=ts[i].phase; rel.push({nextRel[i], i}); }
+        ReadySet<Time> rs; rs.reset(n);
+        Time t=0, boundary = hyper? maxPhase : TIME_MAX; vector<Time> prevState; vector<Stats> prevStats; Time prevBusy=0, prevCs=0, prevSwitches=0;
+        string run="IDLE"; Time runlen=0;
+        auto flush=[&](){ if(runlen>0){ g.push_back(make_pair(run,runlen)); runlen=0; } };
+
+        auto release=[&](){
+            while(!rel.empty() && rel.top().first<=t){
+                int i=rel.top().second; rel.pop();
+                if(nextRel[i]<horizon){
+                    q[i].push_back({nextRel[i], ts[i].wcet, nextRel[i]+ts[i].deadline}); st[i].released++;
+                    if(q[i].size()==1) rs.put(i, key(i));
+                }
+                nextRel[i]+=ts[i].period; rel.push({nextRel[i], i});
+            }
+        };
+
+        while(t<horizon){
+            release();
+            if(t==boundary){
+                vector<Time> s=state(t, nextRel);
+                if(s==prevState){
+                    Time m=(horizon-t-1)/hyper;      // the last skipped boundary stays below the horizon, as its releases are counted
+                    if(m>0){
+                        for(int i=0;i<n;i++){
+                            Stats d=st[i];
+                            st[i].released+=m*(d.released-prevStats[i].released);
+                            st[i].done+=m*(d.done-prevStats[i].done);
+                            st[i].missed+=m*(d.missed-prevStats[i].missed);
+                            st[i].resp+=(__int128)m*(d.resp-prevStats[i].resp);
+                            nextRel[i]+=m*hyper;
+                            for(auto& j: q[i]){ j.release+=m*hyper; j.deadline+=m*hyper; }
+                            if(lastRan[i]>=0) lastRan[i]+=m*hyper;
+                            if(!q[i].empty()) rs.put(i, key(i));
+                        }
+                        busy+=m*(busy-prevBusy); cs+=m*(cs-prevCs); switches+=m*(switches-prevSwitches);
+                        flush(); run="IDLE"; g.push_back(make_pair(string("..."), m*hyper));
+                        skippedAt=t; skipped=m; t+=m*hyper;
+                        rel=decltype(rel)(); for(int i=0;i<n;i++) rel.push({nextRel[i], i});
+                    }
+                    boundary=TIME_MAX;
+                    continue;
+                }
+                prevState=s; prevStats=st; prevBusy=busy; prevCs=cs; prevSwitches=switches; boundary+=hyper;
+            }
+            if(pending>0){
+                Time step=min({pending, boundary-t, horizon-t});
+                if(run!="CS"){ flush(); run="CS"; }
+                runlen+=step; pending-=step; cs+=step; t+=step; continue;
+            }
+            Time nx=min({rel.empty()? TIME_MAX : rel.top().first, horizon, boundary});
+            int i=rs.argmin();
+            if(i<0){
+                if(run!="IDLE"){ flush(); run="IDLE"; }
+                runlen+=nx-t; t=nx; cur=-1; continue;
+            }
+            if(i!=cur){
+                cur=i;
+                pending = !cost.on()? 0 : cost.cswitch + (lastRan[i]<0? 0 : cost.decay>0? cost.warm*min(t-lastRan[i], cost.decay)/cost.decay : cost.warm);
+                if(pending>0){ switches++; continue; }
+            }
+            if(run!=ts[i].id){ flush(); run=ts[i].id; }
+            Job& j=q[i].front();
+            Time step=min(j.remaining, nx-t);
+            j.remaining-=step; runlen+=step; busy+=step; t+=step; lastRan[i]=t;
+            if(j.remaining==0){
+                Time r=t-j.release; Stats& s=st[i];
+                s.done++; s.resp+=r; s.maxResp=max(s.maxResp,r); if(t>j.deadline) s.missed++;
+                q[i].pop_front();
+                if(q[i].empty()) rs.drop(i); else rs.put(i, key(i));
+            }
+        }
+        flush(); release();       // a switch may run into the horizon past releases not yet let in
+        // jobs still pending at the horizon count as misses once their deadline has passed
+        for(int i=0;i<n;i++) for(auto& j: q[i]) if(j.deadline<horizon) st[i].missed++;
+        return true;
+    }
+
+    void printResults(const Gantt& g) const {
+        printGantt(g);
+        Stats tot{};
+        for(auto& s: st){ tot.released+=s.released; tot.done+=s.done; tot.missed+=s.missed; tot.resp+=s.resp; tot.maxResp=max(tot.maxResp,s.maxResp); }
+        cout<<fixed<<setprecision(2);
+        cout<<"Jobs Released: "<<tot.released<<"\n";
+        cout<<"Jobs Completed: "<<tot.done<<"\n";
+        cout<<"Deadline Misses: "<<tot.missed<<"\n";
+        cout<<"Average Response Time: "<<(tot.done? (double)tot.resp/tot.done : 0.0)<<"\n";
+        cout<<"Max Response Time: "<<tot.maxResp<<"\n";
+        cout<<"CPU Utilization: "<<(horizon? 100.0*busy/horizon : 0.0)<<"%\n";
+        if(switches) cout<<"Switch Overhead: "<<cs<<" ("<<(horizon? 100.0*cs/horizon : 0.0)<<"% of time, "<<switches<<" switches)\n";
+        cout<<"Throughput: "<<(horizon? (double)tot.done/horizon : 0.0)<<" jobs/unit time\n";
+        if(skippedAt>=0) cout<<"Hyperperiod: "<<hyper<<" (schedule repeats from t="<<skippedAt-hyper<<", "<<skipped<<" skipped)\n";
+        for(size_t i=0;i<ts.size();i++){
+            const Stats& s=st[i];
+            cout<<"  "<<ts[i].id<<": jobs="<<s.released<<" misses="<<s.missed
+                <<" avg_resp="<<(s.done? (double)s.resp/s.done : 0.0)<<" max_resp="<<s.maxResp<<"\n";
+        }
+    }
 };
 
-// -------- shared helpers --------
-static void ensureRemaining(vector<Process>& ps){ for(auto& p: ps) p.remaining_time=p.burst_time; }
-static void sortByArrival(vector<Process>& ps){
-    sort(ps.begin(), ps.end(), [](const Process&a, const Process&b){return a.arrival_time<b.arrival_time;});
+// -------------- Input --------------
+// Periodic task lines: "periodic ID Phase WCET Period [RelDeadline]"; the relative
+// deadline defaults to the period.
+static vector<PeriodicTask> loadPeriodicTasks(const string& filename){
+    vector<PeriodicTask> ts;
+    ifstream in(filename);
+    if(!in) return ts;
+    string line, kw;
+    while(getline(in,line)){
+        if(!workloadLine(line)) continue;
+        istringstream iss(line); PeriodicTask k;
+        if(!(iss>>kw) || kw!="periodic") continue;
+        if(!(iss>>k.id>>k.phase>>k.wcet>>k.period) || k.wcet<=0 || k.period<=0 || k.phase<0){
+            cerr<<"Bad periodic task: "<<line<<"\n"; continue;
+        }
+        if(!(iss>>k.deadline) || k.deadline<=0) k.deadline=k.period;
+        ts.push_back(k);
+    }
+    return ts;
 }
-static int nextArrivalAfter(const vector<Process>& ps, int t){
-    int nx=INT_MAX; for (auto& p: ps) if(p.remaining_time>0) nx=min(nx, p.arrival_time);
-    return (nx==INT_MAX)? t : nx;
+static vector<Process> generateRandom(int n){
+    vector<Process> ps; ps.reserve(n);
+    mt19937 gen((uint32_t)chrono::high_resolution_clock::now().time_since_epoch().count());
+    uniform_int_distribution<int> A(0,20), B(1,10), P(1,5);
+    for(int i=1;i<=n;i++){
+        Process p; p.id="P"+to_string(i); p.arrival_time=A(gen); p.burst_time=B(gen); p.priority=P(gen);
+        ps.push_back(p);
+    }
+    sortByArrival(ps);
+    return ps;
 }
-static void idleUntil(int& cur, int to, Gantt& g){ if(to>cur){ g.push_back({"IDLE", to-cur}); cur=to; } }
-
-// ================= implementations =================
-
-// FCFS
-class FCFSScheduler: public Scheduler{
-public: string name() const override { return "fcfs"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); int t=0;
-        for (auto& p: ps){
-            if (p.arrival_time>t) idleUntil(t, p.arrival_time, g);
-            g.push_back(make_pair(p.id, p.burst_time));
-            t += p.burst_time;
-            p.turnaround_time = t - p.arrival_time;
-            p.waiting_time    = p.turnaround_time - p.burst_time;
+
+// -------------- Result cache --------------
+// Finished runs are stored under --cache-dir, named by a hash of everything that
+// determines the output: the parsed workload, the policy and its parameters, the
+// lottery seed and the simulator build. Each entry holds its full key, so a hash
+// collision reads as a miss. Writers go through a temp file and rename(), so readers in
+// other processes never see a partial entry. Hits refresh the mtime. Stores add their
+// size to a running total in .size under the directory lock; only when that passes the
+// cap is the directory listed and the oldest entries trimmed, down to 90% of it, so a
+// store costs O(1) until then. Lottery runs without an explicit seed are never stored.
+#ifndef SIM_VERSION
+#define SIM_VERSION __DATE__ " " __TIME__
+#endif
+
+// Two independent FNV-1a lanes, 128 bits in all. Fields are length-prefixed.
+struct Digest{
+    uint64_t a=0xcbf29ce484222325ULL, b=0x6c62272e07bb0142ULL;
+    Digest& add(string_view s){
+        string len=to_string(s.size())+":";
+        for(string_view part: {string_view(len), s}) for(unsigned char c: part){
+            a=(a^c)*0x100000001b3ULL;
+            b=(b^(c+0x9e))*0x100000001b3ULL; b^=b>>31;
         }
-        total=t;
+        return *this;
     }
+    Digest& add(Time v){ return add(to_string(v)); }
+    string hex() const { char h[33]; snprintf(h, sizeof h, "%016llx%016llx", (unsigned long long)a, (unsigned long long)b); return h; }
 };
+static string workloadDigest(const vector<Process>& ps, const map<string,double>& weights){
+    Digest d;
+    for(auto& p: ps){
+        d.add(p.id).add(p.arrival_time).add((Time)p.priority).add(p.deadline).add(p.group);
+        if(p.bursts.empty()) d.add(p.burst_time);
+        for(Time b: p.bursts) d.add(b);
+        for(int v: p.devs) d.add((Time)v);
+    }
+    for(auto& [g,w]: weights){ ostringstream o; o<<setprecision(17)<<w; d.add(g).add(o.str()); }
+    return d.hex();
+}
+static string runKey(const string& format, const string& type, const SchedConfig& cfg, const string& workload){
+    ostringstream k;
+    k<<"build="<<SIM_VERSION<<" format="<<format<<" scheduler="<<type<<" quantum="<<cfg.quantum;
+    if(type=="mlq"){
+        k<<" share="<<cfg.mlqShare<<" classes=";
+        for(auto& c: cfg.mlqClasses) k<<c.lo<<"-"<<c.hi<<":"<<c.disc<<c.quantum<<":"<<c.weight<<",";
+    }
+    if(type=="edf" && !cfg.admission.empty()) k<<" admission="<<cfg.admission;
+    if(cfg.cost.on()) k<<" cswitch="<<cfg.cost.cswitch<<" warm="<<cfg.cost.warm<<" decay="<<cfg.cost.decay<<" migrate="<<cfg.cost.migrate;
+    if(type=="lottery") k<<" seed="<<cfg.seed;
+    if(cfg.power.report){
+        k<<setprecision(17)<<" idle="<<cfg.power.idle<<" governor="<<cfg.governor<<" pstates=";
+        for(size_t l=0;l<cfg.power.freq.size();l++) k<<cfg.power.freq[l]<<":"<<cfg.power.watts[l]<<",";
+    }
+    k<<" workload="<<workload;
+    return k.str();
+}
 
-// SJF (non-preemptive)
-class SJFScheduler: public Scheduler{
-public: string name() const override { return "sjf"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps);
-        int n=ps.size(), t=0, done=0; vector<char> fin(n,0);
-        while(done<n){
-            int idx=-1;
-            for(int i=0;i<n;i++) if(!fin[i] && ps[i].arrival_time<=t)
-                if(idx==-1 || ps[i].burst_time<ps[idx].burst_time) idx=i;
-            if(idx==-1){ idleUntil(t, nextArrivalAfter(ps,t), g); continue; }
-            g.push_back(make_pair(ps[idx].id, ps[idx].burst_time));
-            t+=ps[idx].burst_time;
-            ps[idx].turnaround_time=t-ps[idx].arrival_time;
-            ps[idx].waiting_time=ps[idx].turnaround_time-ps[idx].burst_time;
-            fin[idx]=1; done++;
-        }
-        total=t;
+// --pstates / --power / --governor (pstates=, power=, governor= for the daemon). Any of
+// them turns on the energy report; the P-states default to 40/60/80/100% of full speed.
+static string dvfsConfig(const string& type, const string* pstates, const string* curve, const string* gov, SchedConfig& cfg){
+    if(!pstates && !curve && !gov) return "";
+    if(!parsePowerModel(pstates? *pstates : "0.4,0.6,0.8,1", curve? *curve : "", cfg.power))
+        return "bad P-states or power curve (expected F[:W],... and STATIC,DYNAMIC[,IDLE])";
+    cfg.power.report=true;
+    if(gov){
+        cfg.governor=*gov;
+        if(cfg.governor!="race" && cfg.governor!="steady" && cfg.governor!="deadline") return "unknown governor: "+cfg.governor;
+        if(cfg.governor=="steady" && type!="cfs") return "governor steady needs the cfs scheduler";
+        if(cfg.governor=="deadline" && type!="edf") return "governor deadline needs the edf scheduler";
     }
-};
+    return "";
+}
 
-// SRTF
-class SRTFScheduler: public Scheduler{
-public: string name() const override { return "srtf"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); ensureRemaining(ps);
-        int n=ps.size(), t=0, finished=0; string run="IDLE"; int runlen=0;
-        auto flush=[&](){ if(runlen>0){ g.push_back(make_pair(run,runlen)); runlen=0; } };
-        while(finished<n){
-            int idx=-1, best=INT_MAX, nx=INT_MAX;
-            for(int i=0;i<n;i++){
-                if(ps[i].remaining_time>0){ nx=min(nx, ps[i].arrival_time); }
-                if(ps[i].arrival_time<=t && ps[i].remaining_time>0 && ps[i].remaining_time<best){ best=ps[i].remaining_time; idx=i; }
-            }
-            if(idx==-1){ if(run!="IDLE"){ flush(); run="IDLE"; } runlen+=max(0,nx-t); t=nx; continue; }
-            if(run!=ps[idx].id){ flush(); run=ps[idx].id; }
-            ps[idx].remaining_time--; runlen++; t++;
-            if(ps[idx].remaining_time==0){
-                flush();
-                ps[idx].turnaround_time=t-ps[idx].arrival_time;
-                ps[idx].waiting_time=ps[idx].turnaround_time-ps[idx].burst_time;
-                finished++; run="IDLE";
-            }
+class ResultCache{
+    string dir; size_t cap;
+    static constexpr const char* MAGIC="SIMCACHE1\n";
+    string base(const string& key) const { return dir+"/"+Digest().add(key).hex(); }
+    static bool readFile(const string& path, string& out){
+        ifstream in(path, ios::binary); if(!in) return false;
+        out.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        return true;
+    }
+    // Write through a private temp file, then rename into place.
+    bool publish(const string& path, const function<bool(ostream&)>& write) const {
+        static atomic<uint64_t> counter{0};
+        string tmp=dir+"/.tmp."+to_string(getpid())+"."+to_string(counter++);
+        {   ofstream out(tmp, ios::binary);
+            if(!out || !write(out) || !out.flush()){ unlink(tmp.c_str()); return false; } }
+        if(rename(tmp.c_str(), path.c_str())!=0){ unlink(tmp.c_str()); return false; }
+        return true;
+    }
+    // Lists the directory and drops the oldest entries until at most `keep` bytes remain;
+    // returns what is left. The caller holds the lock.
+    size_t trim(size_t keep) const {
+        namespace fs = std::filesystem;
+        vector<tuple<Time,size_t,string>> files; size_t total=0; error_code ec;
+        Time now=chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+        for(auto& e: fs::directory_iterator(dir, ec)){
+            struct stat st; string name=e.path().filename().string(), path=e.path().string();
+            if(name==".lock" || name==".size" || stat(path.c_str(), &st)!=0) continue;
+            if(name.rfind(".tmp.",0)==0){ if(now-st.st_mtime>3600) unlink(path.c_str()); continue; }   // left by a crashed writer
+            files.emplace_back((Time)st.st_mtim.tv_sec*1000000000+st.st_mtim.tv_nsec, st.st_size, path);
+            total+=st.st_size;
+        }
+        sort(files.begin(), files.end());
+        for(auto& [m,sz,path]: files){
+            if(total<=keep) break;
+            if(unlink(path.c_str())==0 || errno==ENOENT) total-=sz;
         }
-        total=t;
+        return total;
+    }
+    // Adds a store to the running total. Overwrites and outside deletions make it run
+    // high, which only brings the next listing forward; the listing resets it exactly.
+    void account(size_t added) const {
+        int lk=open((dir+"/.lock").c_str(), O_CREAT|O_RDWR, 0644);
+        if(lk<0) return;
+        if(flock(lk, LOCK_EX)!=0){ close(lk); return; }
+        size_t total=0;
+        { ifstream in(dir+"/.size"); if(!(in>>total)) total=SIZE_MAX/2; }   // unknown: list now
+        total+=added;
+        if(total>cap) total=trim(cap/10*9);
+        { ofstream out(dir+"/.size", ios::trunc); out<<total<<"\n"; }
+        close(lk);
+    }
+public:
+    ResultCache(string d, size_t capBytes): dir(move(d)), cap(capBytes) {
+        error_code ec; std::filesystem::create_directories(dir, ec);
+        if(ec) cerr<<"Cannot create cache directory "<<dir<<": "<<ec.message()<<"\n";
     }
+    // On a hit, also copies the cached Gantt index to ganttOut when one is asked for.
+    bool get(const string& key, string& value, const string& ganttOut="") const {
+        string b=base(key), data;
+        if(!readFile(b+".res", data)) return false;
+        size_t hdr=strlen(MAGIC);
+        if(data.compare(0, hdr, MAGIC)!=0 || data.compare(hdr, key.size(), key)!=0 || data.size()<hdr+key.size()+1 || data[hdr+key.size()]!='\n') return false;
+        if(!ganttOut.empty()){
+            error_code ec;
+            if(!std::filesystem::copy_file(b+".gantt", ganttOut, std::filesystem::copy_options::overwrite_existing, ec)) return false;
+            utimensat(AT_FDCWD, (b+".gantt").c_str(), nullptr, 0);
+        }
+        utimensat(AT_FDCWD, (b+".res").c_str(), nullptr, 0);
+        value=data.substr(hdr+key.size()+1);
+        return true;
+    }
+    void put(const string& key, const string& value, const string& ganttFile="") const {
+        string b=base(key), g;
+        if(!ganttFile.empty() && !(readFile(ganttFile, g) && publish(b+".gantt", [&](ostream& o){ return (bool)o.write(g.data(), g.size()); }))) return;
+        if(publish(b+".res", [&](ostream& o){ return (bool)(o<<MAGIC<<key<<"\n"<<value); }))
+            account(strlen(MAGIC)+key.size()+1+value.size()+g.size());
+    }
+    // A lottery run drawn from a time-based seed is never asked for again.
+    static bool reusable(const string& type, bool seeded){ return type!="lottery" || seeded; }
 };
 
-// Priority (non-preemptive, lower number = higher priority) with simple aging
-class PriorityNPScheduler: public Scheduler{
-public: string name() const override { return "priority"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps);
-        const int AGE_STEP=5;
-        int n=ps.size(), t=0, done=0, last_age=0; vector<char> fin(n,0);
-        while(done<n){
-            if(t-last_age>=AGE_STEP){
-                for(int i=0;i<n;i++) if(!fin[i] && ps[i].arrival_time<=t)
-                    ps[i].priority=max(0, ps[i].priority-1);
-                last_age=t;
-            }
-            int idx=-1;
-            for(int i=0;i<n;i++) if(!fin[i] && ps[i].arrival_time<=t){
-                if(idx==-1 || ps[i].priority<ps[idx].priority ||
-                   (ps[i].priority==ps[idx].priority && ps[i].burst_time<ps[idx].burst_time))
-                    idx=i;
+// -------------- Batch mode --------------
+// Runs one policy over many workload files on a pool of worker threads. A byte budget
+// caps how much workload data is loaded at once; a file larger than the whole budget
+// still runs, just alone.
+struct BatchRow{ bool ok=false; size_t n=0; Time makespan=0; double aw=0, at=0, cpu=0, thr=0; };
+
+static vector<string> batchFiles(const string& path){
+    namespace fs = std::filesystem;
+    vector<string> files; error_code ec;
+    if(fs::is_directory(path, ec)){
+        for(auto& e: fs::directory_iterator(path, ec)) if(e.is_regular_file()) files.push_back(e.path().string());
+        sort(files.begin(), files.end());
+        return files;
+    }
+    ifstream in(path);
+    if(!in){ cerr<<"Error opening file: "<<path<<"\n"; return files; }
+    fs::path dir=fs::path(path).parent_path(); string line;
+    while(getline(in,line)){
+        size_t a=line.find_first_not_of(" \t\r"), b=line.find_last_not_of(" \t\r");
+        if(a==string::npos || line[a]=='#') continue;
+        fs::path f=line.substr(a, b-a+1);
+        files.push_back((f.is_relative()? dir/f : f).string());
+    }
+    return files;
+}
+
+static Time percentile(vector<Time>& v, double q){
+    if(v.empty()) return 0;
+    size_t k=min(v.size()-1, (size_t)ceil(q*v.size())-(q>0));
+    nth_element(v.begin(), v.begin()+k, v.end());
+    return v[k];
+}
+
+static int runBatch(const string& path, const string& type, const SchedConfig& cfg, int jobs, size_t budget, const string& outPath){
+    vector<string> files=batchFiles(path);
+    if(files.empty()){ cerr<<"No workload files found in "<<path<<"\n"; return 1; }
+    if(!makeScheduler(type, cfg)){ cerr<<"Unknown scheduler: "<<type<<"\n"; return 1; }
+
+    vector<BatchRow> rows(files.size());
+    vector<Time> waits, turns;                 // pooled over every process of every file
+    mutex mu; condition_variable cv; size_t inflight=0;
+    atomic<size_t> next{0};
+
+    auto worker=[&](){
+        for(size_t f; (f=next++)<files.size(); ){
+            error_code ec; size_t bytes=std::filesystem::file_size(files[f], ec);
+            if(ec) bytes=0;
+            {   unique_lock<mutex> lk(mu);
+                cv.wait(lk, [&]{ return inflight==0 || inflight+bytes<=budget; });
+                inflight+=bytes; }
+            vector<Process> ps=loadProcesses(files[f]);
+            if(!ps.empty()){
+                SchedConfig fc=cfg; fc.groupWeights=loadGroupWeights(files[f]);
+                auto sch=makeScheduler(type, fc); Gantt g; Time total=0;
+                sch->schedule(ps, g, total);
+                BatchRow& r=rows[f]; r.ok=true; r.n=ps.size(); r.makespan=total;
+                calcMetrics(ps, total, g, r.aw, r.at, r.cpu, r.thr);
+                lock_guard<mutex> lk(mu);
+                for(auto& p: ps){ waits.push_back(p.waiting_time); turns.push_back(p.turnaround_time); }
             }
-            if(idx==-1){ idleUntil(t, nextArrivalAfter(ps,t), g); continue; }
-            g.push_back(make_pair(ps[idx].id, ps[idx].burst_time));
-            t+=ps[idx].burst_time;
-            ps[idx].turnaround_time=t-ps[idx].arrival_time;
-            ps[idx].waiting_time=ps[idx].turnaround_time-ps[idx].burst_time;
-            fin[idx]=1; done++;
+            {   lock_guard<mutex> lk(mu); inflight-=bytes; }
+            cv.notify_all();
         }
-        total=t;
+    };
+    vector<thread> pool;
+    for(int i=0;i<max(1,jobs);i++) pool.emplace_back(worker);
+    for(auto& th: pool) th.join();
+
+    ofstream file; if(!outPath.empty()){ file.open(outPath); if(!file){ cerr<<"Error opening file: "<<outPath<<"\n"; return 1; } }
+    ostream& out = outPath.empty()? cout : file;
+    out<<fixed<<setprecision(2);
+    out<<"file\tprocesses\tmakespan\tavg_wait\tavg_turnaround\tcpu_util\tthroughput\n";
+    size_t failed=0;
+    for(size_t f=0; f<files.size(); f++){
+        const BatchRow& r=rows[f];
+        if(!r.ok){ failed++; out<<files[f]<<"\t0\t-\t-\t-\t-\t-\n"; continue; }
+        out<<files[f]<<"\t"<<r.n<<"\t"<<r.makespan<<"\t"<<r.aw<<"\t"<<r.at<<"\t"<<r.cpu<<"\t"<<r.thr<<"\n";
+    }
+    out<<"# files: "<<files.size()-failed<<" ok, "<<failed<<" failed; processes: "<<waits.size()<<"\n";
+    out<<"# waiting p50/p90/p99: "<<percentile(waits,.5)<<" "<<percentile(waits,.9)<<" "<<percentile(waits,.99)<<"\n";
+    out<<"# turnaround p50/p90/p99: "<<percentile(turns,.5)<<" "<<percentile(turns,.9)<<" "<<percentile(turns,.99)<<"\n";
+    return failed==files.size();
+}
+
+// -------------- Trace export --------------
+// Chrome Trace Event JSON, which chrome://tracing and ui.perfetto.dev open, streamed
+// while the engines run. One time unit is written as one microsecond. Tracks:
+//   pid 1 "CPUs"       a thread per CPU holding the job it runs ("switch" = overhead),
+//                      plus counters: jobs runnable on each CPU and MLFQ queue lengths
+//   pid 2 "Processes"  a thread per job: its CPU slices ("run") and blocked time ("I/O")
+// Every CPU appends to its own buffer and hands the file 64 KiB at a time, so parallel
+// cluster nodes share one file and memory stays flat however long the schedule.
+class TraceFile{
+    ofstream out; mutex mu; atomic<int> tids{0};
+public:
+    int cpus=1;
+    bool open(const string& path, int ncpu){
+        cpus=ncpu;
+        out.open(path, ios::binary);
+        if(!out){ cerr<<"Error opening file: "<<path<<"\n"; return false; }
+        out<<"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+             "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"CPUs\"}},\n"
+             "{\"ph\":\"M\",\"pid\":2,\"name\":\"process_name\",\"args\":{\"name\":\"Processes\"}}";
+        for(int c=0;c<cpus;c++) out<<",\n{\"ph\":\"M\",\"pid\":1,\"tid\":"<<c<<",\"name\":\"thread_name\",\"args\":{\"name\":\"cpu"<<c<<"\"}}";
+        return true;
     }
+    void write(const string& chunk){ lock_guard<mutex> lk(mu); out.write(chunk.data(), chunk.size()); }
+    int newTid(){ return tids++; }
+    bool close(){ out<<"\n]}\n"; out.close(); return !out.fail(); }
 };
 
-// Round Robin
-class RRScheduler: public Scheduler{
-    int q;
+class ChromeTrace: public TraceSink{
+    TraceFile& file; int cpu; string buf; vector<int> tid;     // per job index, -1 until first seen
+    // counters are held back until time moves on, so a burst of updates at one
+    // instant becomes a single sample, and unchanged values are not repeated
+    struct Counter{ const char* key; string name; Time t=-1; int64_t v=0, shown=INT64_MIN; };
+    vector<Counter> ctr;
+
+    void num(int64_t v){ char b[24]; buf.append(b, to_chars(b, b+sizeof b, v).ptr-b); }
+    void str(const string& s){
+        buf+='"';
+        for(char c: s){
+            if(c=='"' || c=='\\'){ buf+='\\'; buf+=c; }
+            else if((unsigned char)c<0x20) buf+=' ';
+            else buf+=c;
+        }
+        buf+='"';
+    }
+    void event(const char* ph, int pid, int t, Time ts){
+        buf+=",\n{\"ph\":\""; buf+=ph; buf+="\",\"pid\":"; num(pid); buf+=",\"tid\":"; num(t);
+        buf+=",\"ts\":"; num(ts);
+    }
+    void span(int pid, int t, const string& name, Time start, Time len){
+        event("X", pid, t, start); buf+=",\"dur\":"; num(len); buf+=",\"name\":"; str(name); buf+='}';
+        if(buf.size()>=(1<<16)){ file.write(buf); buf.clear(); }
+    }
+    int procTid(int i, const string& id){
+        if(i>=(int)tid.size()) tid.resize(i+1, -1);
+        if(tid[i]<0){
+            tid[i]=file.newTid();
+            buf+=",\n{\"ph\":\"M\",\"pid\":2,\"tid\":"; num(tid[i]);
+            buf+=",\"name\":\"thread_name\",\"args\":{\"name\":"; str(id); buf+="}}";
+        }
+        return tid[i];
+    }
+    void sample(Counter& c){
+        if(c.t<0 || c.v==c.shown) return;
+        event("C", 1, cpu, c.t); buf+=",\"name\":"; str(c.name); buf+=",\"args\":{\"value\":"; num(c.v); buf+="}}";
+        c.shown=c.v;
+    }
 public:
-    explicit RRScheduler(int quantum): q(quantum) {}
-    string name() const override { return "rr"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); ensureRemaining(ps);
-        int n=ps.size(), t=0, nextIdx=0, fin=0; queue<int> rq;
-        auto arrive=[&](){ while(nextIdx<n && ps[nextIdx].arrival_time<=t) rq.push(nextIdx++); };
-        arrive(); if(rq.empty() && nextIdx<n){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); }
-        while(fin<n){
-            if(rq.empty()){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); continue; }
-            int i=rq.front(); rq.pop();
-            int slice=min(q, ps[i].remaining_time);
-            g.push_back(make_pair(ps[i].id, slice)); t+=slice; ps[i].remaining_time-=slice; arrive();
-            if(ps[i].remaining_time>0) rq.push(i);
-            else { ps[i].turnaround_time=t-ps[i].arrival_time; ps[i].waiting_time=ps[i].turnaround_time-ps[i].burst_time; fin++; }
+    ChromeTrace(TraceFile& f, int cpuIndex): file(f), cpu(cpuIndex) {}
+    ~ChromeTrace(){
+        for(auto& c: ctr) sample(c);
+        if(!buf.empty()) file.write(buf);
+    }
+    void slice(int i, const string& id, Time start, Time len) override {
+        if(len<=0 || id=="IDLE") return;
+        if(i<0){ span(1, cpu, "switch", start, len); return; }
+        span(1, cpu, id, start, len);
+        span(2, procTid(i, id), "run", start, len);
+    }
+    void blocked(int i, const string& id, Time start, Time len) override { span(2, procTid(i, id), "I/O", start, len); }
+    void counter(const char* name, Time t, int64_t v) override {
+        auto it=find_if(ctr.begin(), ctr.end(), [&](const Counter& c){ return !strcmp(c.key, name); });
+        if(it==ctr.end()){
+            ctr.push_back({name, file.cpus>1? string(name)+" cpu"+to_string(cpu) : name});
+            it=ctr.end()-1;
         }
-        total=t;
+        if(t!=it->t) sample(*it);
+        it->t=t; it->v=v;
     }
 };
 
-// MLQ (High RR q=4 if priority<3, else Low FCFS)
-class MLQScheduler: public Scheduler{
-public: string name() const override { return "mlq"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); ensureRemaining(ps);
-        const int RRQ=4;
-        int n=ps.size(), t=0, nextIdx=0, fin=0; queue<int> hi, lo;
-        auto arrive=[&](){
-            while(nextIdx<n && ps[nextIdx].arrival_time<=t){
-                (ps[nextIdx].priority<3 ? hi : lo).push(nextIdx++);
-            }
-        };
-        arrive(); if(hi.empty()&&lo.empty()&&nextIdx<n){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); }
-        while(fin<n){
-            if(!hi.empty()){
-                int i=hi.front(); hi.pop();
-                int slice=min(RRQ, ps[i].remaining_time);
-                g.push_back(make_pair(ps[i].id, slice)); t+=slice; ps[i].remaining_time-=slice; arrive();
-                if(ps[i].remaining_time>0) hi.push(i);
-                else { ps[i].turnaround_time=t-ps[i].arrival_time; ps[i].waiting_time=ps[i].turnaround_time-ps[i].burst_time; fin++; }
-            } else if(!lo.empty()){
-                int i=lo.front(); lo.pop();
-                int run=ps[i].remaining_time;
-                g.push_back(make_pair(ps[i].id, run)); t+=run; ps[i].remaining_time=0; arrive();
-                ps[i].turnaround_time=t-ps[i].arrival_time; ps[i].waiting_time=ps[i].turnaround_time-ps[i].burst_time; fin++;
-            } else {
-                idleUntil(t, ps[nextIdx].arrival_time, g); arrive();
-            }
+// -------------- Cluster mode --------------
+// Jobs are routed to N nodes that each run the chosen policy locally; a job reaches its
+// node `latency` after it arrives. A work-conserving node's outstanding CPU work does
+// not depend on its local policy, so the dispatcher tracks each node's load with a
+// Lindley recursion over the jobs it has sent, counting those still in flight. After
+// routing the nodes never interact, so they are simulated fully in parallel. For jobs
+// with I/O the tracked load is an estimate: a blocked job leaves the CPU idle.
+struct NodeLoad{
+    Time last=0, work=0;                      // outstanding work as of `last`
+    Time inflightWork=0; deque<pair<Time,Time>> inflight;   // (delivery, burst)
+    Time at(Time t){
+        while(!inflight.empty() && inflight.front().first<=t){
+            auto [d,b]=inflight.front(); inflight.pop_front();
+            work=max<Time>(0, work-(d-last))+b; last=d; inflightWork-=b;
         }
-        total=t;
+        return max<Time>(0, work-(t-last))+inflightWork;
     }
+    void send(Time delivery, Time burst){ inflight.push_back({delivery,burst}); inflightWork+=burst; }
 };
 
-// MLFQ (3 queues, RR quanta 2/4/8; demote on full quantum; simple periodic promotion)
-class MLFQScheduler: public Scheduler{
-public: string name() const override { return "mlfq"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); ensureRemaining(ps);
-        const int Q[3]={2,4,8}; const int PROMOTE_PERIOD=12;
-        array<queue<int>,3> q{}; int n=ps.size(), t=0, nextIdx=0, fin=0;
-        for(auto& p:ps) p.qlevel=0;
-
-        auto arrive=[&](){ while(nextIdx<n && ps[nextIdx].arrival_time<=t){ ps[nextIdx].qlevel=0; q[0].push(nextIdx++); } };
-        auto periodicPromote=[&](){
-            if(t==0 || t%PROMOTE_PERIOD) return;
-            for(int L=2; L>=1; --L){
-                int s=q[L].size();
-                while(s--){ int i=q[L].front(); q[L].pop(); q[L-1].push(i); }
-            }
-        };
+static int runCluster(vector<Process> ps, const string& type, const SchedConfig& cfg, int nodes,
+                      const string& dispatch, Time latency, uint32_t seed, int jobs, TraceFile* trace){
+    if(!makeScheduler(type, cfg)){ cerr<<"Unknown scheduler: "<<type<<"\n"; return 1; }
+    if(dispatch!="random" && dispatch!="least" && dispatch!="p2c"){ cerr<<"Unknown dispatch policy: "<<dispatch<<"\n"; return 1; }
+    sortByArrival(ps);
+    mt19937 gen(seed); uniform_int_distribution<int> pick(0, nodes-1);
+    vector<NodeLoad> load(nodes); vector<vector<Process>> local(nodes); size_t rot=0;
+    // Jobs named TASK.N (one per activation, as the trace importer writes them) belong to
+    // one task; an activation placed away from the task's previous node runs cold there.
+    unordered_map<string,int> home;
+    for(auto& p: ps){
+        Time t=p.arrival_time; int k=0;
+        if(dispatch=="random") k=pick(gen);
+        else if(dispatch=="p2c"){ int a=pick(gen), b=pick(gen); k = load[b].at(t)<load[a].at(t)? b : a; }
+        else {   // ties rotate, so idle nodes share the light-load traffic
+            Time best=TIME_MAX; int r=rot++%nodes;
+            for(int j=0;j<nodes;j++){ int i=(r+j)%nodes; Time w=load[i].at(t); if(w<best){ best=w; k=i; } }
+        }
+        Process q=p; q.arrival_time+=latency;
+        size_t dot=p.id.rfind('.');
+        if(dot!=string::npos && dot+1<p.id.size() && all_of(p.id.begin()+dot+1, p.id.end(), [](unsigned char c){ return isdigit(c); })){
+            auto [it,fresh]=home.try_emplace(p.id.substr(0,dot), k);
+            q.migrated = !fresh && it->second!=k; it->second=k;
+        }
+        load[k].send(q.arrival_time, q.burst_time);
+        local[k].push_back(move(q));
+    }
 
-        arrive(); if(q[0].empty()&&q[1].empty()&&q[2].empty()&&nextIdx<n){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); }
-        while(fin<n){
-            periodicPromote();
-            int L = !q[0].empty()?0:(!q[1].empty()?1:(!q[2].empty()?2:-1));
-            if(L==-1){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); continue; }
-            int i=q[L].front(); q[L].pop();
-            int slice=min(Q[L], ps[i].remaining_time);
-            g.push_back(make_pair(ps[i].id, slice)); t+=slice; ps[i].remaining_time-=slice; arrive();
-            if(ps[i].remaining_time>0){
-                int NL = (slice==Q[L] && L<2)? L+1 : L;
-                q[NL].push(i);
-            }else{
-                ps[i].turnaround_time=t-ps[i].arrival_time; ps[i].waiting_time=ps[i].turnaround_time-ps[i].burst_time; fin++;
-            }
+    vector<Time> busy(nodes,0), makespan(nodes,0); vector<double> joules(nodes,0);
+    vector<__int128> wsum(nodes,0), tsum(nodes,0);
+    vector<size_t> count(nodes,0);
+    atomic<int> next{0};
+    auto worker=[&](){
+        for(int k; (k=next++)<nodes; ){
+            if(local[k].empty()) continue;
+            auto sch=makeScheduler(type, cfg); Gantt g; Time total=0;
+            unique_ptr<ChromeTrace> tr; if(trace){ tr=make_unique<ChromeTrace>(*trace, k); sch->io.trace=tr.get(); }
+            sch->schedule(local[k], g, total);
+            tr.reset();
+            count[k]=local[k].size();           // EDF admission may drop jobs
+            makespan[k]=total; joules[k]=sch->energy();
+            for(auto& e: g) if(isWork(e.first)) busy[k]+=e.second;
+            // Waiting and response are measured from the original arrival.
+            for(auto& p: local[k]){ wsum[k]+=p.waiting_time+latency; tsum[k]+=p.turnaround_time+latency; }
+            vector<Process>().swap(local[k]);
         }
-        total=t;
+    };
+    vector<thread> pool;
+    for(int i=0;i<min(max(1,jobs),nodes);i++) pool.emplace_back(worker);
+    for(auto& th: pool) th.join();
+
+    __int128 W=0, T=0; Time span=0, B=0, maxBusy=0;
+    for(int k=0;k<nodes;k++){ W+=wsum[k]; T+=tsum[k]; span=max(span,makespan[k]); B+=busy[k]; maxBusy=max(maxBusy,busy[k]); }
+    double n=accumulate(count.begin(), count.end(), (size_t)0), mean=(double)B/nodes, var=0;
+    for(int k=0;k<nodes;k++) var+=((double)busy[k]-mean)*((double)busy[k]-mean);
+    auto [lo,hi]=minmax_element(count.begin(), count.end());
+    cout<<fixed<<setprecision(2);
+    cout<<"Cluster: "<<nodes<<" nodes, dispatch "<<dispatch<<", latency "<<latency<<", node scheduler "<<type<<"\n";
+    cout<<"Average Waiting Time: "<<(n? (double)W/n : 0.0)<<"\n";
+    cout<<"Average Turnaround Time: "<<(n? (double)T/n : 0.0)<<"\n";
+    cout<<"Makespan: "<<span<<"\n";
+    cout<<"CPU Utilization: "<<(span? 100.0*B/((double)span*nodes) : 0.0)<<"%\n";
+    cout<<"Throughput: "<<(span? n/span : 0.0)<<" processes/unit time\n";
+    cout<<"Load Imbalance (max/mean busy): "<<(mean>0? maxBusy/mean : 0.0)<<"\n";
+    cout<<"Busy Time CoV: "<<(mean>0? sqrt(var/nodes)/mean : 0.0)<<"\n";
+    cout<<"Jobs per Node (min/max): "<<*lo<<"/"<<*hi<<"\n";
+    if(cfg.power.report){   // nodes idle from their own makespan to the cluster's
+        double e=0; for(int k=0;k<nodes;k++) e+=joules[k]+(span-makespan[k])*cfg.power.idle;
+        cout<<"Energy: "<<e<<"\n";
+        cout<<"Energy-Delay Product: "<<e*span<<"\n";
     }
-};
+    return 0;
+}
 
-// Lottery (quantum 4; tickets ~ 10/priority)
-class LotteryScheduler: public Scheduler{
-public: string name() const override { return "lottery"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); ensureRemaining(ps); const int QUANTUM=4;
-        int n=ps.size(), t=0, nextIdx=0, fin=0; vector<int> ready;
-        mt19937 gen((uint32_t)chrono::high_resolution_clock::now().time_since_epoch().count());
-        auto arrive=[&](){
-            while(nextIdx<n && ps[nextIdx].arrival_time<=t) ready.push_back(nextIdx++);
-            ready.erase(remove_if(ready.begin(),ready.end(),[&](int i){return ps[i].remaining_time==0;}), ready.end());
-        };
-        auto tickets=[&](int i){ return max(1, 10 / max(1, ps[i].priority)); };
-
-        arrive(); if(ready.empty()&&nextIdx<n){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); }
-        while(fin<n){
-            if(ready.empty()){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); continue; }
-            int tot=0; for(int i:ready) tot+=tickets(i);
-            uniform_int_distribution<int> dist(1,tot);
-            int pick=dist(gen), acc=0, chosen=ready.front();
-            for(int i:ready){ acc+=tickets(i); if(pick<=acc){ chosen=i; break; } }
-            int slice=min(QUANTUM, ps[chosen].remaining_time);
-            g.push_back(make_pair(ps[chosen].id, slice)); t+=slice; ps[chosen].remaining_time-=slice; arrive();
-            if(ps[chosen].remaining_time==0){
-                ps[chosen].turnaround_time=t-ps[chosen].arrival_time;
-                ps[chosen].waiting_time=ps[chosen].turnaround_time-ps[chosen].burst_time; fin++;
-            }
+// -------------- Trace import --------------
+// Converts ftrace sched_switch/sched_wakeup text (trace, trace_pipe, trace-cmd report)
+// or `perf sched script` output into the workload format. Every activation of a task
+// becomes one job: it arrives when the task is woken, its burst is the CPU time it
+// gets until it next blocks (preemptions stay inside the burst), and its priority is
+// the nice level folded onto the 1..5 scale used here (real-time tasks map to 1). A
+// job is written as soon as its task blocks, so memory only holds the tasks that are
+// runnable at that moment; the simulator sorts by arrival when it loads the file.
+struct TraceTask{ string comm; Time wake=0, ran=0, since=-1; int prio=120; };
+
+static int niceToPriority(int prio){ return prio<100? 1 : min(5, max(1, (prio-100)/8+1)); }
+static string jobName(string s){ for(char& c: s) if(isspace((unsigned char)c) || c=='#' || c==',') c='_'; return s; }
+
+// "5678.123456" -> nanoseconds; -1 if malformed
+static Time parseStamp(string_view s){
+    size_t dot=s.find('.'); Time sec=0, frac=0; int digits=0;
+    if(s.empty() || dot==0) return -1;
+    for(size_t i=0;i<min(dot,s.size());i++){ if(!isdigit((unsigned char)s[i])) return -1; sec=sec*10+(s[i]-'0'); }
+    for(size_t i=dot+1;dot!=string_view::npos && i<s.size();i++){
+        if(!isdigit((unsigned char)s[i])) return -1;
+        if(digits<9){ frac=frac*10+(s[i]-'0'); digits++; }
+    }
+    while(digits<9){ frac*=10; digits++; }
+    return sec*1000000000+frac;
+}
+// Value of "key=" up to the next space, or up to `until` when given (comm may hold spaces).
+static string_view traceField(string_view s, string_view key, string_view until=" "){
+    size_t a=s.find(key); if(a==string_view::npos) return {};
+    a+=key.size(); size_t b=s.find(until, a);
+    return s.substr(a, b==string_view::npos? string_view::npos : b-a);
+}
+static int traceInt(string_view v, int dflt){ int x=dflt; from_chars(v.data(), v.data()+v.size(), x); return x; }
+// trace-cmd's compact "comm:pid [prio] ..." form
+static bool compactTask(string_view s, string& comm, int& pid, int& prio){
+    size_t br=s.find(" ["), colon=s.substr(0,br).rfind(':');
+    if(br==string_view::npos || colon==string_view::npos) return false;
+    comm=string(s.substr(0,colon)); pid=traceInt(s.substr(colon+1, br-colon-1), -1);
+    prio=traceInt(s.substr(br+2), 120);
+    return pid>=0;
+}
+
+static int runImport(int argc, char** argv){
+    if(argc<3){ cerr<<"Usage: simulator import TRACE|- [--out FILE] [--tick-us N]\n"; return 1; }
+    string outPath; Time tick=1000;                      // ns per simulator time unit
+    for(int i=3;i+1<argc;i+=2){
+        string k=argv[i];
+        if(k=="--out") outPath=argv[i+1];
+        else if(k=="--tick-us") tick=max(1LL, stoll(argv[i+1]))*1000;
+        else { cerr<<"Unknown option: "<<k<<"\n"; return 1; }
+    }
+    ifstream file; string inPath=argv[2];
+    if(inPath!="-"){ file.open(inPath); if(!file){ cerr<<"Error opening file: "<<inPath<<"\n"; return 1; } }
+    istream& in = inPath=="-"? cin : file;
+    ofstream ofile; if(!outPath.empty()){ ofile.open(outPath); if(!ofile){ cerr<<"Error opening file: "<<outPath<<"\n"; return 1; } }
+    ostream& out = outPath.empty()? cout : ofile;
+
+    unordered_map<int,TraceTask> live;      // runnable or running tasks
+    unordered_map<int,uint32_t> seq;        // activations written per pid
+    Time t0=-1, last=0; size_t lines=0, events=0, jobs=0, bad=0;
+    out<<"# imported from "<<inPath<<"; 1 time unit = "<<tick/1000<<"us\n";
+    auto emit=[&](int pid, TraceTask& k){
+        if(k.ran<=0) return;
+        Time arr=(k.wake-t0)/tick, burst=max<Time>(1, (k.ran+tick-1)/tick);
+        out<<jobName(k.comm)<<"-"<<pid<<"."<<seq[pid]++<<" "<<arr<<" "<<burst<<" "<<niceToPriority(k.prio)<<"\n";
+        jobs++;
+    };
+    auto wake=[&](int pid, const string& comm, int prio, Time ts){
+        if(pid==0 || live.count(pid)) return;
+        TraceTask& k=live[pid]; k.comm=comm; k.prio=prio; k.wake=ts;
+    };
+
+    string line;
+    while(getline(in,line)){
+        lines++;
+        string_view s(line);
+        size_t e; bool isSwitch;
+        if((e=s.find("sched_switch:"))!=string_view::npos) isSwitch=true;
+        else if((e=s.find("sched_wakeup"))!=string_view::npos) isSwitch=false;
+        else continue;
+        // the timestamp is the "SSSS.UUUUUU:" token right before the (possibly "sched:"-prefixed) event name
+        size_t p=e; if(p>=6 && s.substr(p-6,6)=="sched:") p-=6;
+        while(p>0 && s[p-1]==' ') p--;
+        if(p==0 || s[p-1]!=':'){ bad++; continue; }
+        size_t q=s.rfind(' ', p-1);
+        Time ts=parseStamp(s.substr(q==string_view::npos? 0 : q+1, p-1-(q==string_view::npos? 0 : q+1)));
+        if(ts<0){ bad++; continue; }
+        if(t0<0) t0=ts;
+        last=max(last, ts); events++;
+        string_view body=s.substr(s.find(':', e)+1);
+        while(!body.empty() && body[0]==' ') body.remove_prefix(1);
+
+        if(!isSwitch){
+            string comm; int pid, prio;
+            if(body.find("pid=")!=string_view::npos){
+                comm=string(traceField(body, "comm=", " pid=")); pid=traceInt(traceField(body, " pid="), -1); prio=traceInt(traceField(body, "prio="), 120);
+            } else if(!compactTask(body, comm, pid, prio)){ bad++; continue; }
+            if(pid>0) wake(pid, comm, prio, ts);
+            continue;
+        }
+        string pc, nc, state; int pp, pprio, np, nprio;
+        if(body.find("prev_pid=")!=string_view::npos){
+            pc=string(traceField(body, "prev_comm=", " prev_pid=")); pp=traceInt(traceField(body, "prev_pid="), -1);
+            pprio=traceInt(traceField(body, "prev_prio="), 120); state=string(traceField(body, "prev_state="));
+            nc=string(traceField(body, "next_comm=", " next_pid=")); np=traceInt(traceField(body, "next_pid="), -1);
+            nprio=traceInt(traceField(body, "next_prio="), 120);
+        } else {
+            size_t arrow=body.find(" ==> ");
+            if(arrow==string_view::npos || !compactTask(body.substr(0,arrow), pc, pp, pprio) || !compactTask(body.substr(arrow+5), nc, np, nprio)){ bad++; continue; }
+            string_view l=body.substr(0,arrow); size_t rb=l.find("] ");
+            state = rb==string_view::npos? "" : string(l.substr(rb+2));
+        }
+        if(pp<0 || np<0){ bad++; continue; }
+        if(pp>0){
+            auto it=live.find(pp);
+            if(it!=live.end()){
+                TraceTask& k=it->second;
+                if(k.since>=0){ k.ran+=ts-k.since; k.since=-1; }
+                k.prio=pprio;
+                // anything other than R/R+ means the task blocked, ending the activation
+                if(state.empty() || state[0]!='R'){ emit(pp, k); live.erase(it); }
+            } else if(!state.empty() && state[0]=='R') wake(pp, pc, pprio, ts);   // runnable before the trace began
+        }
+        if(np>0){
+            wake(np, nc, nprio, ts);    // running with no wakeup seen: it was runnable at trace start
+            TraceTask& k=live[np]; k.since=ts; k.prio=nprio;
         }
-        total=t;
+    }
+    // activations still open at the end of the trace keep what they ran so far
+    vector<int> open; for(auto& kv: live) open.push_back(kv.first);
+    sort(open.begin(), open.end());
+    for(int pid: open){ TraceTask& k=live[pid]; if(k.since>=0) k.ran+=last-k.since; emit(pid, k); }
+    cerr<<"Read "<<lines<<" lines, "<<events<<" sched events ("<<bad<<" malformed); wrote "<<jobs<<" jobs\n";
+    return out? 0 : 1;
+}
+
+// -------------- Daemon mode --------------
+// `simulator serve SOCKET` answers simulation requests over a UNIX domain socket so
+// callers skip process startup. A connection carries any number of requests, each one
+// header line of key=value pairs:
+//   scheduler=NAME [quantum=Q] [seed=S] [cs_cost=C cache_penalty=W cache_decay=D]
+//   [mlq_classes=SPEC mlq_share=strict|wrr|drr] [admission=reject|defer]
+//   [pstates=F[:W],... power=STATIC,DYNAMIC[,IDLE] governor=race|steady|deadline]
+//   (input=PATH | inline=BYTES)
+// With inline=BYTES the workload text follows as exactly that many bytes. Each request
+// gets one line of JSON back. Connections are served by a fixed pool of workers that
+// keep their buffers between requests; parsed workloads stay cached by path (checked
+// against size and mtime) or by content digest (checked against the stored text), up
+// to a memory budget. An inline body over --max-inline-mb, or a request that throws
+// (say, out of memory), gets an error reply and the connection is closed. With
+// --cache-dir the replies also go through the on-disk result cache.
+struct Workload{ vector<Process> ps; map<string,double> weights; size_t bytes=0; string digest; };
+
+class WorkloadCache{
+    struct Entry{ shared_ptr<const Workload> w; Time mtime; off_t size; list<string>::iterator pos; string text; };
+    mutex mu; unordered_map<string,Entry> map_; list<string> lru; size_t bytes=0, cap;
+    shared_ptr<const Workload> parse(const string& text){
+        auto w=make_shared<Workload>();
+        istringstream a(text); w->ps=parseProcesses(a);
+        istringstream b(text); w->weights=parseGroupWeights(b);
+        w->bytes=text.size()+w->ps.size()*sizeof(Process);
+        w->digest=workloadDigest(w->ps, w->weights);
+        return w;
+    }
+    shared_ptr<const Workload> lookup(const string& key, Time mtime, off_t size, const string& text=""){
+        lock_guard<mutex> lk(mu);
+        auto it=map_.find(key);
+        if(it==map_.end() || it->second.mtime!=mtime || it->second.size!=size || it->second.text!=text) return nullptr;
+        lru.splice(lru.begin(), lru, it->second.pos);
+        return it->second.w;
+    }
+    void insert(const string& key, shared_ptr<const Workload> w, Time mtime, off_t size, const string& text=""){
+        lock_guard<mutex> lk(mu);
+        if(auto it=map_.find(key); it!=map_.end()){ bytes-=it->second.w->bytes; lru.erase(it->second.pos); map_.erase(it); }
+        lru.push_front(key); map_[key]={w, mtime, size, lru.begin(), text}; bytes+=w->bytes;
+        while(bytes>cap && lru.size()>1){ auto& e=map_[lru.back()]; bytes-=e.w->bytes; map_.erase(lru.back()); lru.pop_back(); }
+    }
+public:
+    explicit WorkloadCache(size_t cap): cap(cap) {}
+    shared_ptr<const Workload> file(const string& path){
+        struct stat st;
+        if(stat(path.c_str(), &st)!=0) return nullptr;
+        Time mtime=(Time)st.st_mtim.tv_sec*1000000000+st.st_mtim.tv_nsec;
+        if(auto w=lookup("file:"+path, mtime, st.st_size)) return w;
+        ifstream in(path, ios::binary); if(!in) return nullptr;
+        string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        auto w=parse(text); insert("file:"+path, w, mtime, st.st_size);
+        return w;
+    }
+    // inline bodies are kept with their entry (already counted in Workload::bytes), so
+    // a digest collision is a miss rather than someone else's workload
+    shared_ptr<const Workload> text(const string& body){
+        string key="inline:"+Digest().add(body).hex();
+        if(auto w=lookup(key, 0, body.size(), body)) return w;
+        auto w=parse(body); insert(key, w, 0, body.size(), body);
+        return w;
     }
 };
 
-// CFS-lite (min vruntime; slice ∝ 1/priority)
-class CFSScheduler: public Scheduler{
-public: string name() const override { return "cfs"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); ensureRemaining(ps); const int BASE_SLICE=4;
-        int n=ps.size(), t=0, nextIdx=0, fin=0; vector<int> ready;
-        auto arrive=[&](){
-            while(nextIdx<n && ps[nextIdx].arrival_time<=t) ready.push_back(nextIdx++);
-            ready.erase(remove_if(ready.begin(),ready.end(),[&](int i){return ps[i].remaining_time==0;}), ready.end());
-        };
-        for(auto& p: ps) p.vruntime=0.0;
-
-        arrive(); if(ready.empty()&&nextIdx<n){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); }
-        while(fin<n){
-            if(ready.empty()){ idleUntil(t, ps[nextIdx].arrival_time, g); arrive(); continue; }
-            int i=*min_element(ready.begin(), ready.end(), [&](int a,int b){
-                if(ps[a].vruntime==ps[b].vruntime) return ps[a].arrival_time<ps[b].arrival_time;
-                return ps[a].vruntime<ps[b].vruntime;
-            });
-            double w = 1.0 / max(1, ps[i].priority);
-            int slice = max(1, min((int)ceil(BASE_SLICE*w), ps[i].remaining_time));
-            g.push_back(make_pair(ps[i].id, slice)); t+=slice; ps[i].remaining_time-=slice; ps[i].vruntime += slice / w; arrive();
-            if(ps[i].remaining_time==0){
-                ps[i].turnaround_time=t-ps[i].arrival_time; ps[i].waiting_time=ps[i].turnaround_time-ps[i].burst_time; fin++;
-                ready.erase(remove(ready.begin(),ready.end(),i), ready.end());
-            }
+static string jsonStr(const string& s){
+    string o="\"";
+    for(char c: s){
+        if(c=='"' || c=='\\'){ o+='\\'; o+=c; }
+        else if((unsigned char)c<0x20){ char b[8]; snprintf(b, sizeof b, "\\u%04x", c); o+=b; }
+        else o+=c;
+    }
+    return o+"\"";
+}
+static string jsonError(const string& msg){ return "{\"ok\":false,\"error\":"+jsonStr(msg)+"}"; }
+
+// Buffered reads from a socket: header lines and fixed-size bodies.
+struct SocketReader{
+    int fd; string buf; size_t pos=0;
+    bool fill(){
+        if(pos>0){ buf.erase(0,pos); pos=0; }
+        char tmp[65536]; ssize_t r;
+        do r=read(fd, tmp, sizeof tmp); while(r<0 && errno==EINTR);
+        if(r<=0) return false;
+        buf.append(tmp, r); return true;
+    }
+    bool line(string& out){
+        for(size_t nl; ; ){
+            if((nl=buf.find('\n', pos))!=string::npos){ out=buf.substr(pos, nl-pos); pos=nl+1; return true; }
+            if(!fill()) return false;
         }
-        total=t;
+    }
+    bool bytes(size_t n, string& out){
+        while(buf.size()-pos<n) if(!fill()) return false;
+        out=buf.substr(pos, n); pos+=n; return true;
     }
 };
+static bool writeAll(int fd, const string& s){
+    for(size_t off=0; off<s.size(); ){
+        ssize_t w=send(fd, s.data()+off, s.size()-off, MSG_NOSIGNAL);
+        if(w<0 && errno==EINTR) continue;
+        if(w<=0) return false;
+        off+=w;
+    }
+    return true;
+}
 
-// EDF (preemptive). If no deadline present, use arrival + 2*burst.
-class EDFScheduler: public Scheduler{
-public: string name() const override { return "edf"; }
-    void schedule(vector<Process>& ps, Gantt& g, int& total) override {
-        sortByArrival(ps); ensureRemaining(ps);
-        for(auto& p: ps) if(p.deadline==0) p.deadline = p.arrival_time + 2*p.burst_time;
-
-        int n=ps.size(), t=0, finished=0; string run="IDLE"; int runlen=0;
-        auto flush=[&](){ if(runlen>0){ g.push_back(make_pair(run,runlen)); runlen=0; } };
-        auto best=[&]()->int{
-            int idx=-1, bestDL=INT_MAX, bestRem=INT_MAX;
-            for(int i=0;i<n;i++) if(ps[i].remaining_time>0 && ps[i].arrival_time<=t){
-                if(ps[i].deadline<bestDL || (ps[i].deadline==bestDL && ps[i].remaining_time<bestRem)){
-                    bestDL=ps[i].deadline; bestRem=ps[i].remaining_time; idx=i;
-                }
+// Per-worker scratch, reused across requests so steady-state runs do not grow the heap.
+struct ServeWorker{
+    vector<Process> ps; Gantt g;
+    size_t maxInline; bool drop=false;      // drop: the stream is out of step (body unread, or the request threw); close after replying
+    explicit ServeWorker(size_t maxInline): maxInline(maxInline) { ps.reserve(4096); g.reserve(1<<16); }
+    string run(WorkloadCache& cache, const ResultCache* results, SocketReader& rd, const string& header){
+        drop=false;
+        istringstream iss(header); string tok, type, input; SchedConfig cfg; long long inl=-1; bool seeded=false;
+        map<string,string> dvfs;
+        try{
+            while(iss>>tok){
+                size_t eq=tok.find('=');
+                if(eq==string::npos) return jsonError("expected key=value: "+tok);
+                string k=tok.substr(0,eq), v=tok.substr(eq+1);
+                if(k=="scheduler") type=v;
+                else if(k=="quantum") cfg.quantum=max(1, stoi(v));
+                else if(k=="seed"){ cfg.seed=(uint32_t)stoul(v); seeded=true; }
+                else if(k=="mlq_classes"){ if(!parseMLQClasses(v, cfg.mlqClasses)) return jsonError("bad mlq_classes: "+v); }
+                else if(k=="mlq_share"){ if(v!="strict" && v!="wrr" && v!="drr") return jsonError("bad mlq_share: "+v); cfg.mlqShare=v; }
+                else if(k=="admission"){ if(v!="reject" && v!="defer") return jsonError("bad admission: "+v); cfg.admission=v; }
+                else if(k=="cs_cost") cfg.cost.cswitch=max(0LL, stoll(v));
+                else if(k=="cache_penalty") cfg.cost.warm=max(0LL, stoll(v));
+                else if(k=="cache_decay") cfg.cost.decay=max(0LL, stoll(v));
+                else if(k=="pstates" || k=="power" || k=="governor") dvfs[k]=v;
+                else if(k=="input") input=v;
+                else if(k=="inline"){ inl=stoll(v); if(inl<0) return jsonError("bad inline length: "+v); }
+                else return jsonError("unknown key: "+k);
             }
-            return idx;
-        };
+        }catch(...){ return jsonError("bad number in request"); }
+        auto opt=[&](const char* k){ return dvfs.count(k)? &dvfs[k] : nullptr; };
+        string err=dvfsConfig(type, opt("pstates"), opt("power"), opt("governor"), cfg);
+        if(!err.empty()) return jsonError(err);
+        if(inl>=0 && (size_t)inl>maxInline){ drop=true; return jsonError("inline body of "+to_string(inl)+" bytes exceeds the limit of "+to_string(maxInline)); }
+        string body;
+        if(inl>=0 && !rd.bytes(inl, body)) return "";
+        shared_ptr<const Workload> w = inl>=0? cache.text(body) : !input.empty()? cache.file(input) : nullptr;
+        if(!w) return jsonError(input.empty() && inl<0? "no workload given" : "cannot read workload: "+input);
+        if(w->ps.empty()) return jsonError("no processes in workload");
+        cfg.groupWeights=w->weights;
+        auto sch=makeScheduler(type, cfg);
+        if(!sch) return jsonError("unknown scheduler: "+type);
+        string key, hit;
+        if(!ResultCache::reusable(type, seeded)) results=nullptr;
+        if(results){ key=runKey("json", type, cfg, w->digest); if(results->get(key, hit)) return hit; }
+        ps.assign(w->ps.begin(), w->ps.end()); g.clear(); Time total=0;
+        sch->schedule(ps, g, total);
+        double aw,at,cpu,thr; calcMetrics(ps, total, g, aw, at, cpu, thr);
+        ostringstream o; o<<fixed<<setprecision(4);
+        o<<"{\"ok\":true,\"scheduler\":"<<jsonStr(sch->name())<<",\"processes\":"<<ps.size()<<",\"makespan\":"<<total
+         <<",\"avg_wait\":"<<aw<<",\"avg_turnaround\":"<<at<<",\"cpu_util\":"<<cpu<<",\"throughput\":"<<thr;
+        if(!sch->io.dev.empty()){ double iou,ov; ioMetrics(g, sch->io, total, iou, ov); o<<",\"io_util\":"<<iou<<",\"overlap\":"<<ov; }
+        if(cfg.power.report) o<<",\"energy\":"<<sch->energy()<<",\"edp\":"<<sch->energy()*total;
+        o<<"}";
+        if(results) results->put(key, o.str());
+        return o.str();
+    }
+};
 
-        while(finished<n){
-            int idx = best();
-            if(idx==-1){
-                int nx=nextArrivalAfter(ps,t);
-                if(run!="IDLE"){ flush(); run="IDLE"; }
-                runlen += max(0, nx-t); t=nx; continue;
-            }
-            if(run!=ps[idx].id){ flush(); run=ps[idx].id; }
-            ps[idx].remaining_time--; runlen++; t++;
-            if(ps[idx].remaining_time==0){
-                flush();
-                ps[idx].turnaround_time=t-ps[idx].arrival_time;
-                ps[idx].waiting_time=ps[idx].turnaround_time-ps[idx].burst_time; finished++; run="IDLE";
+static int runServe(int argc, char** argv){
+    if(argc<3){ cerr<<"Usage: simulator serve SOCKET [--jobs N] [--cache-mb M] [--cache-dir DIR] [--cache-max-mb M] [--max-inline-mb M]\n"; return 1; }
+    string path=argv[2], cacheDir; int jobs=(int)max(1u, thread::hardware_concurrency()); size_t cacheMB=256, resultMB=1024, inlineMB=64;
+    for(int i=3;i+1<argc;i+=2){
+        string k=argv[i];
+        if(k=="--jobs") jobs=max(1, stoi(argv[i+1]));
+        else if(k=="--cache-mb") cacheMB=max(1, stoi(argv[i+1]));
+        else if(k=="--cache-dir") cacheDir=argv[i+1];
+        else if(k=="--cache-max-mb") resultMB=max(1, stoi(argv[i+1]));
+        else if(k=="--max-inline-mb") inlineMB=max(1, stoi(argv[i+1]));
+        else { cerr<<"Unknown option: "<<k<<"\n"; return 1; }
+    }
+    sockaddr_un addr{}; addr.sun_family=AF_UNIX;
+    if(path.size()>=sizeof addr.sun_path){ cerr<<"Socket path too long: "<<path<<"\n"; return 1; }
+    strcpy(addr.sun_path, path.c_str());
+    struct stat st;
+    if(lstat(path.c_str(), &st)==0 && S_ISSOCK(st.st_mode)) unlink(path.c_str());   // stale socket from an earlier run
+    int lfd=socket(AF_UNIX, SOCK_STREAM, 0);
+    if(lfd<0 || bind(lfd, (sockaddr*)&addr, sizeof addr)<0 || listen(lfd, 128)<0){
+        cerr<<"Cannot listen on "<<path<<": "<<strerror(errno)<<"\n"; return 1;
+    }
+
+    WorkloadCache cache(cacheMB<<20);
+    unique_ptr<ResultCache> results; if(!cacheDir.empty()) results=make_unique<ResultCache>(cacheDir, resultMB<<20);
+    mutex mu; condition_variable cv; deque<int> conns; atomic<bool> stop{false};
+    auto worker=[&](){
+        ServeWorker sw(inlineMB<<20);
+        for(;;){
+            int fd;
+            {   unique_lock<mutex> lk(mu);
+                cv.wait(lk, [&]{ return stop || !conns.empty(); });
+                if(conns.empty()) return;
+                fd=conns.front(); conns.pop_front(); }
+            SocketReader rd{fd}; string header;
+            while(rd.line(header)){
+                if(!header.empty() && header.back()=='\r') header.pop_back();
+                if(header.empty()) continue;
+                if(header=="shutdown"){ stop=true; shutdown(lfd, SHUT_RDWR); writeAll(fd, "{\"ok\":true}\n"); break; }
+                string reply;
+                // a workload that breaks the parser or the engine fails its own request, not the daemon;
+                // the connection is dropped since the body may be half read
+                try{ reply=sw.run(cache, results.get(), rd, header); }
+                catch(const exception& e){ reply=jsonError(string("request failed: ")+e.what()); sw.drop=true; }
+                if(reply.empty() || !writeAll(fd, reply+"\n") || sw.drop) break;
             }
+            close(fd);
         }
-        total=t;
+    };
+    vector<thread> pool;
+    for(int i=0;i<jobs;i++) pool.emplace_back(worker);
+    cerr<<"Listening on "<<path<<" with "<<jobs<<" workers\n";
+    while(!stop){
+        int fd=accept(lfd, nullptr, nullptr);
+        if(fd<0){ if(errno==EINTR || errno==ECONNABORTED) continue; break; }
+        {   lock_guard<mutex> lk(mu); conns.push_back(fd); }
+        cv.notify_one();
     }
-};
+    stop=true; cv.notify_all();
+    for(auto& th: pool) th.join();
+    close(lfd); unlink(path.c_str());
+    return 0;
+}
 
-// -------------- Input --------------
-static vector<Process> loadProcesses(const string& filename){
-    vector<Process> ps;
-    if(filename.empty()) return ps;
-    ifstream in(filename);
-    if(!in){ cerr<<"Error opening file: "<<filename<<"\n"; return ps; }
-    string line;
-    while(getline(in,line)){
-        // strip leading spaces
-        size_t i=line.find_first_not_of(" \t\r\n");
-        if(i==string::npos) continue;
-        if(line[i]=='#') continue;
-        // remove inline comment
-        size_t hash=line.find('#'); if(hash!=string::npos) line=line.substr(0,hash);
-        istringstream iss(line);
-        Process p{};
-        if(!(iss>>p.id>>p.arrival_time>>p.burst_time>>p.priority)) continue;
-        if(iss>>p.deadline) { /* explicit deadline parsed */ }
-        ps.push_back(p);
+// -------------- Gantt index --------------
+// Binary schedule file, written once per run and queried through mmap. Layout, every
+// section 8-byte aligned:
+//   GanttHeader
+//   GanttSlice slices[nslices]       process slices in start order (the start-time index);
+//                                    IDLE and CS time are left out, as in calcMetrics
+//   Time       busy[nslices+1]       prefix sum of CPU time before each slice
+//   uint64_t   proc_off[nprocs+1]    per-process slice index, CSR into proc_slices
+//   uint64_t   proc_slices[nslices]
+//   uint64_t   name_off[nprocs+1]    process ids, offsets into names
+//   uint64_t   name_order[nprocs]    process numbers sorted by id
+//   char       names[names_bytes]
+struct GanttHeader{ char magic[8]; uint64_t nslices, nprocs, total_time, names_bytes; };
+struct GanttSlice{ Time start, len; int64_t proc; };
+static const char GANTT_MAGIC[8]={'G','A','N','T','I','D','X','1'};
+
+static bool writeGanttIndex(const string& path, const vector<Process>& ps, const Gantt& g, Time total){
+    unordered_map<string,int64_t> pid; vector<string> names;
+    for(auto& p: ps) if(pid.emplace(p.id, (int64_t)names.size()).second) names.push_back(p.id);
+    vector<GanttSlice> sl; Time t=0;
+    for(auto& e: g){
+        if(isWork(e.first)){
+            auto it=pid.find(e.first);
+            if(it==pid.end()){ it=pid.emplace(e.first, (int64_t)names.size()).first; names.push_back(e.first); }
+            sl.push_back({t, e.second, it->second});
+        }
+        t+=e.second;
     }
-    return ps;
-}
-static vector<Process> defaultProcesses(){
-    return { {"P1",0,8,2}, {"P2",1,4,1}, {"P3",2,9,3}, {"P4",3,5,4} };
+    uint64_t n=sl.size(), np=names.size();
+    vector<Time> busy(n+1,0); for(uint64_t i=0;i<n;i++) busy[i+1]=busy[i]+sl[i].len;
+    vector<uint64_t> off(np+1,0), idx(n);
+    for(auto& s: sl) off[s.proc+1]++;
+    for(uint64_t p=0;p<np;p++) off[p+1]+=off[p];
+    { vector<uint64_t> fill(off.begin(), off.end()-1); for(uint64_t i=0;i<n;i++) idx[fill[sl[i].proc]++]=i; }
+    vector<uint64_t> noff(np+1,0), order(np);
+    string blob; for(uint64_t p=0;p<np;p++){ blob+=names[p]; noff[p+1]=blob.size(); }
+    blob.resize((blob.size()+7)/8*8, '\0');
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b){ return names[a]<names[b]; });
+
+    ofstream out(path, ios::binary);
+    if(!out){ cerr<<"Error opening file: "<<path<<"\n"; return false; }
+    GanttHeader h{}; memcpy(h.magic, GANTT_MAGIC, 8); h.nslices=n; h.nprocs=np; h.total_time=total; h.names_bytes=blob.size();
+    auto put=[&](const void* p, size_t bytes){ out.write((const char*)p, bytes); };
+    put(&h, sizeof h); put(sl.data(), n*sizeof(GanttSlice)); put(busy.data(), (n+1)*sizeof(Time));
+    put(off.data(), (np+1)*8); put(idx.data(), n*8); put(noff.data(), (np+1)*8); put(order.data(), np*8);
+    put(blob.data(), blob.size());
+    return (bool)out;
 }
-static vector<Process> generateRandom(int n){
-    vector<Process> ps; ps.reserve(n);
-    mt19937 gen((uint32_t)chrono::high_resolution_clock::now().time_since_epoch().count());
-    uniform_int_distribution<int> A(0,20), B(1,10), P(1,5);
-    for(int i=1;i<=n;i++){
-        Process p; p.id="P"+to_string(i); p.arrival_time=A(gen); p.burst_time=B(gen); p.priority=P(gen);
-        ps.push_back(p);
+
+class GanttIndex{
+    void* base=MAP_FAILED; size_t bytes=0;
+public:
+    const GanttHeader* h=nullptr; const GanttSlice* sl=nullptr; const Time* busy=nullptr;
+    const uint64_t *proc_off=nullptr, *proc_slices=nullptr, *name_off=nullptr, *name_order=nullptr; const char* names=nullptr;
+
+    ~GanttIndex(){ if(base!=MAP_FAILED) munmap(base, bytes); }
+    bool open(const string& path){
+        int fd=::open(path.c_str(), O_RDONLY);
+        if(fd<0){ cerr<<"Error opening file: "<<path<<"\n"; return false; }
+        struct stat st; fstat(fd, &st); bytes=st.st_size;
+        if(bytes>=sizeof(GanttHeader)) base=mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(base==MAP_FAILED || memcmp(base, GANTT_MAGIC, 8)){ cerr<<"Not a Gantt index: "<<path<<"\n"; return false; }
+        h=(const GanttHeader*)base;
+        uint64_t n=h->nslices, np=h->nprocs;
+        size_t need=sizeof(GanttHeader)+n*sizeof(GanttSlice)+(n+1)*8+(np+1)*8+n*8+(np+1)*8+np*8+h->names_bytes;
+        if(bytes<need){ cerr<<"Truncated Gantt index: "<<path<<"\n"; return false; }
+        const char* p=(const char*)base+sizeof(GanttHeader);
+        sl=(const GanttSlice*)p;       p+=n*sizeof(GanttSlice);
+        busy=(const Time*)p;           p+=(n+1)*8;
+        proc_off=(const uint64_t*)p;   p+=(np+1)*8;
+        proc_slices=(const uint64_t*)p; p+=n*8;
+        name_off=(const uint64_t*)p;   p+=(np+1)*8;
+        name_order=(const uint64_t*)p; p+=np*8;
+        names=p;
+        return true;
     }
-    sortByArrival(ps);
-    return ps;
+    string_view name(uint64_t p) const { return string_view(names+name_off[p], name_off[p+1]-name_off[p]); }
+    // Slice covering t, or -1 when the CPU was idle or switching.
+    int64_t at(Time t) const {
+        auto it=upper_bound(sl, sl+h->nslices, t, [](Time v, const GanttSlice& s){ return v<s.start; });
+        if(it==sl) return -1;
+        --it; return t<it->start+it->len? it-sl : -1;
+    }
+    // First slice that ends after t.
+    uint64_t from(Time t) const {
+        return partition_point(sl, sl+h->nslices, [&](const GanttSlice& s){ return s.start+s.len<=t; })-sl;
+    }
+    // CPU time used in [0,t).
+    Time busyBefore(Time t) const {
+        uint64_t k=from(t);
+        return busy[k] + (k<h->nslices && sl[k].start<t ? t-sl[k].start : 0);
+    }
+    int64_t proc(string_view id) const {
+        auto it=lower_bound(name_order, name_order+h->nprocs, id, [&](uint64_t p, string_view v){ return name(p)<v; });
+        return (it!=name_order+h->nprocs && name(*it)==id)? (int64_t)*it : -1;
+    }
+};
+
+// simulator query FILE at T | range T1 T2 | util T1 T2 | proc ID
+static int runQuery(int argc, char** argv){
+    if(argc<4){ cerr<<"Usage: simulator query FILE (at T | range T1 T2 | util T1 T2 | proc ID)\n"; return 1; }
+    GanttIndex gi; if(!gi.open(argv[2])) return 1;
+    string op=argv[3];
+    auto printSlice=[&](uint64_t k){ cout<<gi.name(gi.sl[k].proc)<<" ["<<gi.sl[k].start<<", "<<gi.sl[k].start+gi.sl[k].len<<")\n"; };
+    cout<<fixed<<setprecision(2);
+    if(op=="at" && argc==5){
+        Time t=stoll(argv[4]); int64_t k=gi.at(t);
+        cout<<"t="<<t<<": ";
+        if(k<0) cout<<"IDLE\n"; else printSlice(k);
+    } else if((op=="range" || op=="util") && argc==6){
+        Time t1=stoll(argv[4]), t2=stoll(argv[5]);
+        if(t2<=t1){ cerr<<"Empty range\n"; return 1; }
+        if(op=="range") for(uint64_t k=gi.from(t1); k<gi.h->nslices && gi.sl[k].start<t2; k++) printSlice(k);
+        cout<<"CPU Utilization: "<<100.0*(gi.busyBefore(t2)-gi.busyBefore(t1))/(t2-t1)<<"%\n";
+    } else if(op=="proc" && argc==5){
+        int64_t p=gi.proc(argv[4]);
+        if(p<0){ cerr<<"Unknown process: "<<argv[4]<<"\n"; return 1; }
+        Time cpu=0;
+        for(uint64_t j=gi.proc_off[p]; j<gi.proc_off[p+1]; j++){ printSlice(gi.proc_slices[j]); cpu+=gi.sl[gi.proc_slices[j]].len; }
+        cout<<"Slices: "<<gi.proc_off[p+1]-gi.proc_off[p]<<"  CPU time: "<<cpu<<"\n";
+    } else { cerr<<"Unknown query: "<<op<<"\n"; return 1; }
+    return 0;
 }
 
 // -------------- main --------------
 int main(int argc, char** argv){
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
+    if(argc>1 && string(argv[1])=="query") return runQuery(argc, argv);
+    if(argc>1 && string(argv[1])=="import") return runImport(argc, argv);
+    if(argc>1 && string(argv[1])=="serve") return runServe(argc, argv);
 
     map<string,string> args;
     for(int i=1;i+1<=argc-1;i+=2) args[argv[i]]=argv[i+1];
     string type = args.count("--scheduler")? args["--scheduler"] : "rr";
     string input= args.count("--input")? args["--input"] : "";
-    int quantum = args.count("--quantum")? max(1, stoi(args["--quantum"])) : 4;
+    SchedConfig cfg;
+    cfg.quantum = args.count("--quantum")? max(1, stoi(args["--quantum"])) : 4;
     bool useRandom = args.count("--random");
     int numRandom = args.count("--num")? max(1, stoi(args["--num"])) : 10;
+    string ganttOut = args.count("--gantt-out")? args["--gantt-out"] : "";
+    string traceOut = args.count("--trace-out")? args["--trace-out"] : "";
+    if(args.count("--seed")) cfg.seed = (uint32_t)stoul(args["--seed"]);
+    if(args.count("--mlq-classes") && !parseMLQClasses(args["--mlq-classes"], cfg.mlqClasses)){
+        cerr<<"Bad --mlq-classes: "<<args["--mlq-classes"]<<" (expected LO-HI:fcfs|sjf|rrQ[:WEIGHT],...)\n"; return 1;
+    }
+    if(args.count("--mlq-share")){
+        cfg.mlqShare=args["--mlq-share"];
+        if(cfg.mlqShare!="strict" && cfg.mlqShare!="wrr" && cfg.mlqShare!="drr"){ cerr<<"Unknown --mlq-share: "<<cfg.mlqShare<<"\n"; return 1; }
+    }
+    if(args.count("--admission")){
+        cfg.admission=args["--admission"];
+        if(cfg.admission!="reject" && cfg.admission!="defer"){ cerr<<"Unknown --admission: "<<cfg.admission<<"\n"; return 1; }
+    }
+    if(args.count("--cs-cost")) cfg.cost.cswitch = max(0LL, stoll(args["--cs-cost"]));
+    if(args.count("--cache-penalty")) cfg.cost.warm = max(0LL, stoll(args["--cache-penalty"]));
+    if(args.count("--cache-decay")) cfg.cost.decay = max(0LL, stoll(args["--cache-decay"]));
+    if(args.count("--migration-cost")) cfg.cost.migrate = max(0LL, stoll(args["--migration-cost"]));
+    auto opt=[&](const char* k){ return args.count(k)? &args[k] : nullptr; };
+    string err=dvfsConfig(type, opt("--pstates"), opt("--power"), opt("--governor"), cfg);
+    if(!err.empty()){ cerr<<"DVFS: "<<err<<"\n"; return 1; }
+    if(args.count("--crossover")) SELECT_CROSSOVER = max(1, stoi(args["--crossover"]));
+
+    if(args.count("--batch")){
+        int jobs = args.count("--jobs")? max(1, stoi(args["--jobs"])) : (int)max(1u, thread::hardware_concurrency());
+        size_t budgetMB = args.count("--max-inflight-mb")? max(1, stoi(args["--max-inflight-mb"])) : 1024;
+        return runBatch(args["--batch"], type, cfg, jobs, budgetMB<<20, args.count("--batch-out")? args["--batch-out"] : "");
+    }
+
+    vector<PeriodicTask> tasks = input.empty()? vector<PeriodicTask>{} : loadPeriodicTasks(input);
+    if(!tasks.empty()){
+        if(type!="edf" && type!="rm"){ cerr<<"Periodic tasks need --scheduler edf or rm\n"; return 1; }
+        if(!ganttOut.empty() || !traceOut.empty()) cerr<<"--gantt-out and --trace-out are not supported for periodic tasks\n";
+        if(cfg.cost.migrate>0) cerr<<"--migration-cost has no effect on periodic tasks, which never change node\n";
+        PeriodicSim sim(type=="rm"? PeriodicSim::RM : PeriodicSim::EDF); sim.cost=cfg.cost;
+        Time horizon = args.count("--horizon")? max(1LL, stoll(args["--horizon"])) : 0;
+        Gantt g; if(!sim.run(tasks, horizon, args.count("--hyperperiod-stop") && args["--hyperperiod-stop"]!="0", g)) return 1;
+        sim.printResults(g);
+        return 0;
+    }
 
     vector<Process> ps = useRandom ? generateRandom(numRandom)
                                    : (!input.empty()? loadProcesses(input) : defaultProcesses());
     if(ps.empty()){ cerr<<"No processes loaded.\n"; return 1; }
+    if(!input.empty()) cfg.groupWeights = loadGroupWeights(input);
+    if(args.count("--cluster")){
+        int jobs = args.count("--jobs")? max(1, stoi(args["--jobs"])) : (int)max(1u, thread::hardware_concurrency());
+        int nodes = max(1, stoi(args["--cluster"]));
+        TraceFile tf; if(!traceOut.empty() && !tf.open(traceOut, nodes)) return 1;
+        int rc = runCluster(move(ps), type, cfg, nodes, args.count("--dispatch")? args["--dispatch"] : "least",
+                            args.count("--dispatch-latency")? max(0LL, stoll(args["--dispatch-latency"])) : 1, cfg.seed, jobs,
+                            traceOut.empty()? nullptr : &tf);
+        if(!traceOut.empty() && !tf.close()){ cerr<<"Error writing trace: "<<traceOut<<"\n"; return 1; }
+        return rc;
+    }
+
+    unique_ptr<Scheduler> sch = makeScheduler(type, cfg);
+    if(!sch){ cerr<<"Unknown scheduler: "<<type<<"\n"; return 1; }
 
-    unique_ptr<Scheduler> sch;
-    if      (type=="fcfs")    sch = make_unique<FCFSScheduler>();
-    else if (type=="sjf")     sch = make_unique<SJFScheduler>();
-    else if (type=="srtf")    sch = make_unique<SRTFScheduler>();
-    else if (type=="priority")sch = make_unique<PriorityNPScheduler>();
-    else if (type=="rr")      sch = make_unique<RRScheduler>(quantum);
-    else if (type=="mlq")     sch = make_unique<MLQScheduler>();
-    else if (type=="mlfq")    sch = make_unique<MLFQScheduler>();
-    else if (type=="lottery") sch = make_unique<LotteryScheduler>();
-    else if (type=="cfs")     sch = make_unique<CFSScheduler>();
-    else if (type=="edf")     sch = make_unique<EDFScheduler>();
-    else { cerr<<"Unknown scheduler: "<<type<<"\n"; return 1; }
-
-    Gantt g; int total=0;
+    unique_ptr<ResultCache> cache; string key;
+    if(args.count("--cache-dir") && ResultCache::reusable(type, args.count("--seed"))){
+        size_t capMB = args.count("--cache-max-mb")? max(1, stoi(args["--cache-max-mb"])) : 1024;
+        cache = make_unique<ResultCache>(args["--cache-dir"], capMB<<20);
+        key = runKey("text", type, cfg, workloadDigest(ps, cfg.groupWeights));
+        string hit;
+        if(traceOut.empty() && cache->get(key, hit, ganttOut)){ cout<<hit; return 0; }   // a trace needs the real run
+    }
+    ostringstream captured; streambuf* console = cache? cout.rdbuf(captured.rdbuf()) : nullptr;
+    TraceFile tf; unique_ptr<ChromeTrace> tr;
+    if(!traceOut.empty()){
+        if(!tf.open(traceOut, 1)) return 1;
+        tr=make_unique<ChromeTrace>(tf, 0); sch->io.trace=tr.get();
+    }
+    Gantt g; Time total=0;
     sch->schedule(ps, g, total);
-    printResults(ps, total, g);
+    if(tr){
+        tr.reset(); sch->io.trace=nullptr;
+        if(!tf.close()){ cerr<<"Error writing trace: "<<traceOut<<"\n"; return 1; }
+    }
+    printResults(ps, total, g, sch->io);
+    sch->printStats();
+    if(cfg.power.report) printEnergy(*sch, ps, total);
+    if(cache){ cout.rdbuf(console); cout<<captured.str(); }
+    if(!ganttOut.empty() && !writeGanttIndex(ganttOut, ps, g, total)) return 1;
+    if(cache) cache->put(key, captured.str(), ganttOut);
     return 0;
 }